@@ -31,6 +31,8 @@
 #import <VLCMedia.h>
 #import <VLCAudio.h>
 #import <VLCMediaMetaData.h>
+#import <VLCMediaOptionTemplate.h>
+#import <VLCThumbnailSpriteSheet.h>
 #import <VLCAudioEqualizer.h>
 #import <VLCMediaPlayerTitleDescription.h>
 #if !TARGET_OS_TV
@@ -92,6 +94,24 @@ NS_ASSUME_NONNULL_BEGIN
  * \return The receiver's internal media descriptor pointer.
  */
 @property (readonly) void * libVLCMediaDescriptor;
+
+/**
+ * Drops the cached track wrappers so that the next access refetches them.
+ * Called when the media is parsed and whenever a player reports ES changes.
+ */
+- (void)invalidateTracksCache;
+
+/**
+ * The options added through addOption:, addOptions: and mediaWithMedia:andLibVLCOptions:
+ * in the order they were added. libvlc cannot report the options of a descriptor.
+ */
+@property (readonly, copy) NSArray<NSString *> *libVLCOptions;
+
+/**
+ * Records options already applied to the descriptor without applying them again.
+ * \param options the libvlc option strings
+ */
+- (void)recordLibVLCOptions:(NSArray<NSString *> *)options;
 @end
 
 /**
@@ -236,6 +256,19 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+/**
+ * Bridges functionality between libvlc and VLCMediaMetaDataSnapshot implementation.
+ */
+@interface VLCMediaMetaDataSnapshot (LibVLCBridging)
+
+/**
+ * \param values meta values keyed by boxed libvlc_meta_t, NSString, NSURL or NSNumber
+ * \param extra meta extra values keyed by name
+ */
+- (instancetype)initWithValues:(NSDictionary<NSNumber *, id> *)values extra:(NSDictionary<NSString *, NSString *> *)extra;
+
+@end
+
 /**
  * Bridges functionality between libvlc and VLCMediaPlayerTrack implementation.
  */
@@ -276,4 +309,55 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+/**
+ * Bridges functionality between libvlc and VLCMediaOptionTemplate implementation.
+ */
+@interface VLCMediaOptionTemplate (LibVLCBridging)
+
+/**
+ * Adds all options of the template to a raw media descriptor.
+ * \param md LibVLC media descriptor pointer, may be NULL.
+ */
+- (void)applyToLibVLCMediaDescriptor:(libvlc_media_t *)md;
+
+@end
+
+/**
+ * Bridges functionality between libvlc and VLCThumbnailSpriteSheet implementation.
+ */
+@interface VLCThumbnailSpriteSheet (LibVLCBridging)
+
+/**
+ * \param duration_ms the length of the media in milliseconds
+ * \return a black sheet, nil if a parameter is 0 or the buffer can't be allocated
+ */
+- (nullable instancetype)initWithTileCount:(NSUInteger)tileCount
+                                   columns:(NSUInteger)columns
+                                      rows:(NSUInteger)rows
+                                 tileWidth:(unsigned)tileWidth
+                                tileHeight:(unsigned)tileHeight
+                                  duration:(int64_t)duration_ms;
+
+/**
+ * bytes per line of the shared buffer, the pitch frames must be decoded with
+ */
+@property (readonly) size_t pitch;
+
+/**
+ * \return where the tile starts in the shared buffer, a scratch area if index is out of range
+ */
+- (void *)pixelsOfTileAtIndex:(NSUInteger)index;
+
+/**
+ * \return the time the tile is taken at, in milliseconds
+ */
+- (int64_t)timeOfTileAtIndex:(NSUInteger)index;
+
+/**
+ * create the images once no frame is decoded into the buffer anymore
+ */
+- (void)createImages;
+
+@end
+
 NS_ASSUME_NONNULL_END
@@ -0,0 +1,65 @@
+/*****************************************************************************
+ * VLCMediaList+Internal.h: VLCKit.framework VLCMediaList internal header
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLCMediaList_Internal_h
+#define VLCMediaList_Internal_h
+
+#import <VLCMediaList.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Lets observers of the media key tell which changes a snapshot already holds.
+ * Every change of the media bumps the generation once and is notified with
+ * the generation it reached.
+ */
+@interface VLCMediaList (Internal)
+
+/**
+ * the current generation
+ */
+@property (readonly) NSUInteger mediaGeneration;
+
+/**
+ * \return the generation reached by the change being notified on the calling thread,
+ * NSNotFound outside of a media change notification of a list
+ */
++ (NSUInteger)notifiedMediaGeneration;
+
+/**
+ * \param generation receives the generation of the returned snapshot
+ * \return the same as media
+ */
+- (NSArray<VLCMedia *> *)mediaWithGeneration:(nullable NSUInteger *)generation;
+
+/**
+ * \param generation receives the generation the count belongs to
+ * \return the same as count
+ */
+- (NSUInteger)mediaCountWithGeneration:(NSUInteger *)generation;
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+#endif /* VLCMediaList_Internal_h */
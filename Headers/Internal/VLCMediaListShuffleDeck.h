@@ -0,0 +1,99 @@
+/*****************************************************************************
+ * VLCMediaListShuffleDeck.h: VLCKit.framework VLCMediaListShuffleDeck header
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Picks the indexes of a list in random order, each once per round, and keeps
+ * a bounded history of the picks to walk back and forth through.
+ *
+ * The deck only knows the number of items. It has to be told about every
+ * insertion and removal of the list, and then keeps the round and the history
+ * on the same items. A pick costs O(1), a change of the list O(count).
+ * Not thread-safe.
+ */
+@interface VLCMediaListShuffleDeck : NSObject
+
+/**
+ * \param count the number of items of the list
+ * \param historyLimit the number of picks kept in the history, at least 2
+ */
+- (instancetype)initWithCount:(NSUInteger)count historyLimit:(NSUInteger)historyLimit NS_DESIGNATED_INITIALIZER;
+
+/**
+ * the number of items of the list
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/**
+ * the number of picks kept in the history, at least 2 for the current one and the one drawn ahead
+ */
+@property (nonatomic) NSUInteger historyLimit;
+
+/**
+ * starts a new round with an empty history
+ * \param count the number of items of the list
+ */
+- (void)resetWithCount:(NSUInteger)count;
+
+/**
+ * records an item picked by the user as the current one, replacing the one drawn ahead
+ */
+- (void)markIndexAsCurrent:(NSUInteger)index;
+
+/**
+ * \param repeat whether to start a new round once every item was picked
+ * \return the next pick, NSNotFound at the end of the round or if the list is empty
+ */
+- (NSUInteger)nextIndexRepeating:(BOOL)repeat;
+
+/**
+ * \return the pick nextIndexRepeating: will return, without moving to it
+ */
+- (NSUInteger)peekNextIndexRepeating:(BOOL)repeat;
+
+/**
+ * \return the pick before the current one, NSNotFound at the start of the history
+ */
+- (NSUInteger)previousIndex;
+
+/**
+ * follows an insertion into the list, the new items are unpicked
+ * \param indexes the indexes of the new items once inserted
+ */
+- (void)insertIndexes:(NSIndexSet *)indexes;
+
+/**
+ * follows a removal from the list, the removed items leave the history
+ * \param indexes the indexes of the removed items before the removal
+ */
+- (void)removeIndexes:(NSIndexSet *)indexes;
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
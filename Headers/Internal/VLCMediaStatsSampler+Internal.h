@@ -0,0 +1,45 @@
+/*****************************************************************************
+ * VLCMediaStatsSampler+Internal.h: VLCKit.framework VLCMediaStatsSampler internal header
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLCMediaStatsSampler_Internal_h
+#define VLCMediaStatsSampler_Internal_h
+
+#import <VLCMediaStatsSampler.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface VLCMediaStatsSampler (Internal)
+
+/**
+ * Derives a sample from raw counters, as the timer does with the statistics of the media.
+ * The first call after init, stop or reset only records the reference counters.
+ * \param counters VLCMediaStatsMetricCount raw counters indexed by metric, bytes for the bitrates
+ * \param date_us the date of the counters in microseconds
+ */
+- (void)addSampleWithCounters:(const int64_t *)counters date:(int64_t)date_us;
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+#endif /* VLCMediaStatsSampler_Internal_h */
@@ -0,0 +1,69 @@
+/*****************************************************************************
+ * VLCVideoFramePool.h: VLCKit.framework VLCVideoFramePool header
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#import <Foundation/Foundation.h>
+#import <CoreGraphics/CoreGraphics.h>
+#import <VLCVideoFrame.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Buffers the video output of a player decodes into, handed in turn to a
+ * frame handler as VLCVideoFrame.
+ * The pool is used by the video outputs created after -attachToPlayer:,
+ * each of them keeps it alive from the setup of its format to its cleanup.
+ */
+@interface VLCVideoFramePool : NSObject
+
+/**
+ * \param handler the block receiving the frames
+ * \param pixelFormat the pixel format of the frames
+ * \param size the size of the frames, 0 for a dimension following the video
+ * \param bufferCount the number of buffers, at least 1
+ * \param queue the queue the handler is called on, nil for a private serial queue
+ */
+- (instancetype)initWithHandler:(VLCVideoFrameHandler)handler
+                    pixelFormat:(VLCVideoFramePixelFormat)pixelFormat
+                           size:(CGSize)size
+                    bufferCount:(NSUInteger)bufferCount
+                          queue:(nullable dispatch_queue_t)queue NS_DESIGNATED_INITIALIZER;
+
+/**
+ * sets the video callbacks of the player to the pool
+ */
+- (void)attachToPlayer:(libvlc_media_player_t *)playerInstance;
+
+/**
+ * gives the buffer of a frame back
+ * \param index the bufferIndex of the frame
+ * \param generation the generation of the buffers the frame was decoded in
+ * \param buffer the buffer of the frame, freed if it is no longer part of the pool
+ */
+- (void)recycleBufferAtIndex:(NSUInteger)index generation:(NSUInteger)generation buffer:(void *)buffer;
+
+- (instancetype)init NS_UNAVAILABLE;
++ (instancetype)new NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,96 @@
+/*****************************************************************************
+ * VLCArtworkCache.h: VLCKit.framework VLCArtworkCache header
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#import <Foundation/Foundation.h>
+#import <CoreGraphics/CoreGraphics.h>
+#import <VLCMediaMetaData.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * An in-memory cache of artwork decoded at a given size.
+ *
+ * Images are decoded on a background queue directly at the requested size,
+ * so the full resolution bitmap is never kept around. Entries are keyed by
+ * artwork URL and size and evicted least recently used first once the
+ * decoded bytes exceed totalCostLimit. All methods are thread-safe.
+ * \see VLCMediaMetaData artworkWithSize:completionHandler:
+ */
+OBJC_VISIBLE
+@interface VLCArtworkCache : NSObject
+
+/**
+ * the cache used by VLCMediaMetaData
+ */
+@property (class, readonly) VLCArtworkCache *sharedCache;
+
+/**
+ * maximum number of bytes of decoded images kept, 32 MiB by default
+ * \note lowering the limit evicts entries immediately
+ */
+@property (atomic) NSUInteger totalCostLimit;
+
+/**
+ * number of bytes of decoded images currently held
+ */
+@property (atomic, readonly) NSUInteger totalCost;
+
+/**
+ * number of images currently held
+ */
+@property (atomic, readonly) NSUInteger count;
+
+/**
+ * pixels per point of the decoded images, the scale of the main screen by default,
+ * 1 on watchOS and visionOS which have none
+ * \note images decoded at another scale are kept apart
+ */
+@property (atomic) CGFloat scale;
+
+/**
+ * Returns a cached image without decoding anything.
+ * \param url the artwork URL
+ * \param size the size the image was requested at, in points
+ * \return the image or nil if it is not in the cache
+ */
+- (nullable VLCPlatformImage *)cachedImageForURL:(NSURL *)url size:(CGSize)size;
+
+/**
+ * Decodes a local image at the given size on a background queue, unless it is
+ * already cached. Concurrent requests for the same image share a single decode.
+ * \param url a file URL to the artwork
+ * \param size the bounding size in points, decoded at scale pixels per point, the aspect ratio is preserved
+ * \param completionHandler called on the main queue, with nil if the image could not be decoded
+ */
+- (void)loadImageForURL:(NSURL *)url
+                   size:(CGSize)size
+      completionHandler:(void (^)(VLCPlatformImage * _Nullable image))completionHandler;
+
+/**
+ * drop all cached images
+ */
+- (void)removeAllImages;
+
+@end
+
+NS_ASSUME_NONNULL_END
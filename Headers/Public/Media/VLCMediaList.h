@@ -76,6 +76,30 @@ OBJC_VISIBLE
  */
 - (instancetype)initWithArray:(nullable NSArray<VLCMedia *> *)array;
 
+/**
+ * initializer restoring a list saved with writeToURL:error:
+ *
+ * The file is memory-mapped and its entries are turned into media without
+ * parsing them, their VLCMedia objects are only created when first accessed.
+ * The saved duration and key metadata are available right away.
+ * \param url the file URL to read
+ * \param error set if the file cannot be read or is not a valid list
+ * \return the restored list, nil on failure
+ */
+- (nullable instancetype)initWithContentsOfURL:(NSURL *)url error:(NSError **)error;
+
+/**
+ * save the list to a compact binary file
+ *
+ * Each entry keeps its MRL, the options added through VLCMedia, its duration
+ * if known and its title, artist, album, album artist, genre, track number,
+ * date and artwork URL.
+ * \param url the file URL to write, replaced atomically
+ * \param error set if the file cannot be written
+ * \return YES on success
+ */
+- (BOOL)writeToURL:(NSURL *)url error:(NSError **)error;
+
 /* Operations */
 /**
  * lock the media list from being edited by another thread
@@ -115,6 +139,39 @@ OBJC_VISIBLE
  */
 - (BOOL)removeMediaAtIndex:(NSUInteger)index;
 
+/**
+ * add several media to the end of a read-write list at once
+ *
+ * The libvlc list is locked once and key-value observers of \c media are
+ * notified with a single change covering all the new indexes.
+ * \param mediaArray the media objects to add
+ * \return the range of indexes of the newly added media, of length 0 if nothing was added
+ * \note this function silently fails if the list is read-only
+ */
+- (NSRange)addMediaFromArray:(NSArray<VLCMedia *> *)mediaArray;
+
+/**
+ * remove several media at once
+ *
+ * \param indexes the indexes of the media to remove
+ * \return NO if indexes is empty or one of the indexes is out of bounds, in which case nothing is removed
+ * \note this function silently fails if the list is read-only
+ */
+- (BOOL)removeMediaAtIndexes:(NSIndexSet *)indexes;
+
+/**
+ * move several media at once, keeping their relative order
+ *
+ * Key-value observers of \c media are notified with a single replacement
+ * change covering every index between the source and destination positions.
+ * \param indexes the indexes of the media to move
+ * \param index the position of the first moved media once the move is done,
+ * at most the list count minus the number of moved media
+ * \return NO if one of the indexes is out of bounds, in which case nothing is moved
+ * \note this function silently fails if the list is read-only
+ */
+- (BOOL)moveMediaAtIndexes:(NSIndexSet *)indexes toIndex:(NSUInteger)index;
+
 /**
  * retrieve a media from a given position
  *
@@ -139,6 +196,19 @@ OBJC_VISIBLE
  */
 @property (readonly) NSInteger count;
 
+/**
+ * an immutable snapshot of the media in the list
+ *
+ * Taking it does not wait for other threads and it does not change while they
+ * modify the list, so enumerate it rather than calling mediaAtIndex: in a loop.
+ * Successive calls without intervening changes return the same array.
+ * \note lists created or filled by libvlc, such as subitems, and lists read
+ * from a file make their VLCMedia on first access, taking the snapshot makes
+ * all of them. On large lists, prefer count and mediaAtIndex: for the items
+ * actually shown.
+ */
+@property (readonly, copy) NSArray<VLCMedia *> *media;
+
 /**
  * delegate property to listen to addition/removal events
  */
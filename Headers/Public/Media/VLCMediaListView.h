@@ -0,0 +1,111 @@
+/*****************************************************************************
+ * VLCMediaListView.h: VLCKit.framework VLCMediaListView header
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#import <Foundation/Foundation.h>
+
+@class VLCMedia, VLCMediaList, VLCMediaListView;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * called after the view changed
+ * \param view the view that changed
+ * \param removedIndexes the indexes removed from the view, relative to its content before the change
+ * \param insertedIndexes the indexes inserted into the view, relative to its content after the change
+ */
+typedef void (^VLCMediaListViewChangeHandler)(VLCMediaListView *view,
+                                              NSIndexSet *removedIndexes,
+                                              NSIndexSet *insertedIndexes);
+
+/**
+ * A sorted and filtered live view of a VLCMediaList.
+ *
+ * Sort descriptors and the predicate are evaluated against VLCMedia, for
+ * instance with the key paths "metaData.title", "metaData.date" or "length".
+ * Additions and removals in the list are merged into the view by binary
+ * insertion instead of sorting the whole list again.
+ *
+ * The view does not notice when the sort keys of a media change, for instance
+ * once it got parsed; call reload in that case. All methods are thread-safe.
+ */
+OBJC_VISIBLE
+@interface VLCMediaListView : NSObject
+
+/**
+ * \param mediaList the list to observe
+ * \param sortDescriptors the order of the view, media comparing equal keep their relative order
+ * \param predicate optional filter, only media it accepts are part of the view
+ */
+- (instancetype)initWithMediaList:(VLCMediaList *)mediaList
+                  sortDescriptors:(NSArray<NSSortDescriptor *> *)sortDescriptors
+                        predicate:(nullable NSPredicate *)predicate NS_DESIGNATED_INITIALIZER;
+
+/**
+ * the observed list
+ */
+@property (nonatomic, readonly) VLCMediaList *mediaList;
+
+/**
+ * the order of the view
+ */
+@property (nonatomic, readonly, copy) NSArray<NSSortDescriptor *> *sortDescriptors;
+
+/**
+ * the filter of the view, nil if every media is included
+ */
+@property (nonatomic, readonly, copy, nullable) NSPredicate *predicate;
+
+/**
+ * an immutable snapshot of the sorted and filtered media
+ */
+@property (readonly, copy) NSArray<VLCMedia *> *media;
+
+/**
+ * number of media in the view
+ */
+@property (readonly) NSUInteger count;
+
+/**
+ * \param index an index in the view
+ * \return the media at that index, nil if out of bounds
+ */
+- (nullable VLCMedia *)mediaAtIndex:(NSUInteger)index;
+
+/**
+ * Optional block called after every change of the view, on the thread that
+ * modified the list. The indexes can be fed to a table view batch update.
+ */
+@property (copy, nullable) VLCMediaListViewChangeHandler changeHandler;
+
+/**
+ * sort and filter the whole list again, reported as the removal of all the
+ * previous content followed by the insertion of the new one
+ */
+- (void)reload;
+
++ (instancetype)new NS_UNAVAILABLE;
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -22,6 +22,7 @@
  *****************************************************************************/
 
 #import <Foundation/Foundation.h>
+#import <CoreGraphics/CoreGraphics.h>
 #if TARGET_OS_IPHONE
 #import <UIKit/UIImage.h>
 #else
@@ -41,6 +42,8 @@ VLCPlatformImage;
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class VLCMediaMetaDataSnapshot;
+
 /**
  * VLCMediaMetaData
  */
@@ -179,6 +182,8 @@ NS_SWIFT_NAME(VLCMedia.MetaData)
 
 /**
  * artwork
+ * \note this decodes the full size image on the calling thread,
+ * prefer artworkWithSize:completionHandler: for lists
  */
 @property(nonatomic, readonly, nullable) VLCPlatformImage *artwork;
 
@@ -205,6 +210,25 @@ NS_SWIFT_NAME(VLCMedia.MetaData)
 
 - (void)clearCache;
 
+/**
+ * Fetch every meta and meta extra of the media in a single pass and
+ * return them as an immutable value. The cache is filled at the same time,
+ * so subsequent reads of the individual properties are cheap.
+ * This can be called from any thread.
+ * \note as for prefetch, the media must have been parsed or played before
+ */
+- (VLCMediaMetaDataSnapshot *)snapshot;
+
+/**
+ * Decode the artwork on a background queue at the given size. Results are
+ * kept in VLCArtworkCache.sharedCache, so requesting the same artwork at the
+ * same size again is answered from memory.
+ * \param size the bounding size in points, the aspect ratio is preserved
+ * \param completionHandler called on the main queue, with nil if there is no local artwork
+ */
+- (void)artworkWithSize:(CGSize)size
+      completionHandler:(void (^)(VLCPlatformImage * _Nullable artwork))completionHandler;
+
 /**
  * Read the meta extra of the media.
  */
@@ -217,4 +241,154 @@ NS_SWIFT_NAME(VLCMedia.MetaData)
 
 @end
 
+/**
+ * An immutable copy of all the metadata of a media, taken at once.
+ *
+ * Snapshots are plain values: reading them never calls into libvlc and
+ * they can be passed between threads freely.
+ * \see VLCMediaMetaData snapshot
+ */
+NS_SWIFT_NAME(VLCMedia.MetaDataSnapshot)
+@interface VLCMediaMetaDataSnapshot : NSObject <NSCopying>
+
+/**
+ * meta title
+ */
+@property(nonatomic, copy, readonly, nullable) NSString *title;
+
+/**
+ * meta artist
+ */
+@property(nonatomic, copy, readonly, nullable) NSString *artist;
+
+/**
+ * meta genre
+ */
+@property(nonatomic, copy, readonly, nullable) NSString *genre;
+
+/**
+ * meta copyright
+ */
+@property(nonatomic, copy, readonly, nullable) NSString *copyright;
+
+/**
+ * meta album
+ */
+@property(nonatomic, copy, readonly, nullable) NSString *album;
+
+/**
+ * meta track number
+ */
+@property(nonatomic, readonly) unsigned trackNumber;
+
+/**
+ * meta description
+ */
+@property(nonatomic, copy, readonly, nullable) NSString *metaDescription;
+
+/**
+ * meta rating
+ */
+@property(nonatomic, copy, readonly, nullable) NSString *rating;
+
+/**
+ * meta date
+ */
+@property(nonatomic, copy, readonly, nullable) NSString *date;
+
+/**
+ * meta setting
+ */
+@property(nonatomic, copy, readonly, nullable) NSString *setting;
+
+/**
+ * meta url
+ */
+@property(nonatomic, copy, readonly, nullable) NSURL *url;
+
+/**
+ * meta language
+ */
+@property(nonatomic, copy, readonly, nullable) NSString *language;
+
+/**
+ * meta now playing
+ */
+@property(nonatomic, copy, readonly, nullable) NSString *nowPlaying;
+
+/**
+ * meta publisher
+ */
+@property(nonatomic, copy, readonly, nullable) NSString *publisher;
+
+/**
+ * meta encoded by
+ */
+@property(nonatomic, copy, readonly, nullable) NSString *encodedBy;
+
+/**
+ * meta artwork URL
+ */
+@property(nonatomic, copy, readonly, nullable) NSURL *artworkURL;
+
+/**
+ * meta track ID
+ */
+@property(nonatomic, readonly) unsigned trackID;
+
+/**
+ * meta track total
+ */
+@property(nonatomic, readonly) unsigned trackTotal;
+
+/**
+ * meta director
+ */
+@property(nonatomic, copy, readonly, nullable) NSString *director;
+
+/**
+ * meta season
+ */
+@property(nonatomic, readonly) unsigned season;
+
+/**
+ * meta episode
+ */
+@property(nonatomic, readonly) unsigned episode;
+
+/**
+ * meta show name
+ */
+@property(nonatomic, copy, readonly, nullable) NSString *showName;
+
+/**
+ * meta actors
+ */
+@property(nonatomic, copy, readonly, nullable) NSString *actors;
+
+/**
+ * meta album artist
+ */
+@property(nonatomic, copy, readonly, nullable) NSString *albumArtist;
+
+/**
+ * meta disc number
+ */
+@property(nonatomic, readonly) unsigned discNumber;
+
+/**
+ * meta disc total
+ */
+@property(nonatomic, readonly) unsigned discTotal;
+
+/**
+ * all the meta extra of the media, empty if there are none
+ */
+@property(nonatomic, copy, readonly) NSDictionary<NSString *, NSString *> *extra;
+
++ (instancetype)new NS_UNAVAILABLE;
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
 NS_ASSUME_NONNULL_END
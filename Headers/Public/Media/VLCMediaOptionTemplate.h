@@ -0,0 +1,80 @@
+/*****************************************************************************
+ * VLCMediaOptionTemplate.h: VLCKit.framework VLCMediaOptionTemplate header
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#import <Foundation/Foundation.h>
+
+@class VLCMedia;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * An immutable set of media options, formatted and UTF-8 encoded once
+ * so that it can be applied to any number of media without further work.
+ *
+ * Instances are thread-safe and can be shared freely.
+ * \see VLCMedia addOptions:
+ */
+OBJC_VISIBLE
+@interface VLCMediaOptionTemplate : NSObject
+
+/**
+ * Creates a template from key/value pairs, using the same format as
+ * VLCMedia addOptions:. Pass NSNull as value for options without argument.
+ * \param options the options to precompile
+ */
+- (instancetype)initWithOptions:(NSDictionary<NSString *, id> *)options;
+
+/**
+ * Creates a template from already formatted options such as "network-caching=1000".
+ * \param optionStrings the options to precompile, in the order they will be applied
+ */
+- (instancetype)initWithOptionStrings:(NSArray<NSString *> *)optionStrings NS_DESIGNATED_INITIALIZER;
+
+/**
+ * the options held by the template, formatted as passed to libvlc
+ */
+@property (nonatomic, readonly, copy) NSArray<NSString *> *optionStrings;
+
+/**
+ * number of options held by the template
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/**
+ * add all options of the template to a media
+ * \param media the media to configure
+ */
+- (void)applyToMedia:(VLCMedia *)media;
+
+/**
+ * add all options of the template to every media of an array
+ * \param mediaArray the media to configure
+ */
+- (void)applyToMediaArray:(NSArray<VLCMedia *> *)mediaArray;
+
++ (instancetype)new NS_UNAVAILABLE;
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
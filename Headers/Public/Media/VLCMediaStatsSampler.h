@@ -0,0 +1,155 @@
+/*****************************************************************************
+ * VLCMediaStatsSampler.h: VLCKit.framework VLCMediaStatsSampler header
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#import <Foundation/Foundation.h>
+
+@class VLCMedia;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Periodically samples the statistics of a media on a background queue and
+ * keeps the derived per-second rates in a fixed-size ring buffer.
+ *
+ * All samplers share a single utility queue, so monitoring many streams at
+ * once only costs one timer per media. Reading values is thread-safe.
+ * \see VLCMedia.statistics
+ */
+OBJC_VISIBLE
+@interface VLCMediaStatsSampler : NSObject
+
+/**
+ * list of per-second rates derived from two consecutive media statistics samples
+ */
+typedef NS_ENUM(NSUInteger, VLCMediaStatsMetric) {
+    VLCMediaStatsMetricInputBitrate = 0,        ///< bits read by the input per second
+    VLCMediaStatsMetricDemuxBitrate,            ///< bits read by the demuxer per second
+    VLCMediaStatsMetricDemuxCorruptionRate,     ///< corrupted packets per second
+    VLCMediaStatsMetricDecodedVideoRate,        ///< decoded video blocks per second
+    VLCMediaStatsMetricDecodedAudioRate,        ///< decoded audio blocks per second
+    VLCMediaStatsMetricDisplayedPictureRate,    ///< displayed pictures per second
+    VLCMediaStatsMetricDroppedPictureRate,      ///< late and lost pictures per second
+    VLCMediaStatsMetricLostAudioBufferRate,     ///< lost audio buffers per second
+    VLCMediaStatsMetricCount
+} NS_SWIFT_NAME(VLCMediaStatsSampler.Metric);
+
+/**
+ * minimum, average and maximum of a metric over a number of samples
+ */
+struct VLCMediaStatsWindow
+{
+    double      minimum;
+    double      average;
+    double      maximum;
+    NSUInteger  sampleCount;    ///< 0 if no sample fell into the window
+} NS_SWIFT_NAME(VLCMediaStatsSampler.Window);
+typedef struct VLCMediaStatsWindow VLCMediaStatsWindow;
+
+/**
+ * Initializes a sampler for the given media.
+ * \param media the media to sample, usually the one being played
+ * \param interval the sampling interval in seconds, clamped to at least 0.1s
+ * \param capacity the number of samples kept in the ring buffer, at least 2
+ * \note the sampler does not start on its own, call start
+ */
+- (instancetype)initWithMedia:(VLCMedia *)media
+                     interval:(NSTimeInterval)interval
+                     capacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+/**
+ * convenience initializer sampling every second and keeping one minute of history
+ */
+- (instancetype)initWithMedia:(VLCMedia *)media;
+
+/**
+ * the sampled media
+ */
+@property (nonatomic, readonly) VLCMedia *media;
+
+/**
+ * sampling interval in seconds
+ */
+@property (nonatomic, readonly) NSTimeInterval interval;
+
+/**
+ * maximum number of samples kept
+ */
+@property (nonatomic, readonly) NSUInteger capacity;
+
+/**
+ * number of samples currently held in the ring buffer
+ */
+@property (nonatomic, readonly) NSUInteger sampleCount;
+
+/**
+ * YES between start and stop
+ */
+@property (nonatomic, readonly, getter=isRunning) BOOL running;
+
+/**
+ * Optional block called on the sampler queue after every new sample.
+ * Keep it short, it delays the sampling of every other media.
+ */
+@property (copy, nullable) void (^sampleHandler)(VLCMediaStatsSampler *sampler);
+
+/**
+ * start sampling, does nothing if already running
+ */
+- (void)start;
+
+/**
+ * stop sampling, the collected samples are kept
+ */
+- (void)stop;
+
+/**
+ * drop all collected samples
+ */
+- (void)reset;
+
+/**
+ * the most recent value of a metric
+ * \param metric the metric to read
+ * \return the value, 0 if fewer than two samples were taken
+ */
+- (double)latestValueForMetric:(VLCMediaStatsMetric)metric;
+
+/**
+ * minimum, average and maximum of a metric over all samples in the ring buffer
+ * \param metric the metric to aggregate
+ */
+- (VLCMediaStatsWindow)windowForMetric:(VLCMediaStatsMetric)metric;
+
+/**
+ * minimum, average and maximum of a metric over the most recent samples
+ * \param metric the metric to aggregate
+ * \param duration the window length in seconds, counted back from the latest sample
+ */
+- (VLCMediaStatsWindow)windowForMetric:(VLCMediaStatsMetric)metric duration:(NSTimeInterval)duration;
+
++ (instancetype)new NS_UNAVAILABLE;
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,103 @@
+/*****************************************************************************
+ * VLCMetadataWriter.h: VLCKit.framework VLCMetadataWriter header
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#import <Foundation/Foundation.h>
+
+@class VLCMedia, VLCMediaMetaData;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * called on the main queue once the metadata of a media was written
+ * \param media the media whose metadata was saved
+ * \param success NO if libvlc failed to write the file
+ */
+typedef void (^VLCMetadataWriterCompletionHandler)(VLCMedia *media, BOOL success);
+
+/**
+ * Persists metadata edits of many media in the background.
+ *
+ * Saves run on a bounded number of background workers. Edits queued for a
+ * media that is still waiting to be written are coalesced, so the file is
+ * only written once for all of them. Edits queued while the media is being
+ * written are saved afterwards, a file is never written by two workers at
+ * once. All methods are thread-safe.
+ */
+OBJC_VISIBLE
+@interface VLCMetadataWriter : NSObject
+
+/**
+ * a writer using as many workers as there are active processors, at most 4
+ */
+- (instancetype)init;
+
+/**
+ * \param maximumConcurrentSaves the number of files written in parallel, at least 1
+ */
+- (instancetype)initWithMaximumConcurrentSaves:(NSUInteger)maximumConcurrentSaves NS_DESIGNATED_INITIALIZER;
+
+/**
+ * the number of files written in parallel
+ */
+@property (nonatomic, readonly) NSUInteger maximumConcurrentSaves;
+
+/**
+ * number of media waiting to be written, excluding the ones being written
+ */
+@property (atomic, readonly) NSUInteger pendingCount;
+
+/**
+ * Queue an edit followed by a save.
+ * \param media the media to edit
+ * \param edit block applied on a background worker right before saving, it can use
+ * any VLCMediaMetaData setter. Edits of a pending media are applied in queueing order.
+ * \param completionHandler optional, called once the media was saved
+ */
+- (void)updateMedia:(VLCMedia *)media
+          withBlock:(void (^)(VLCMediaMetaData *metaData))edit
+  completionHandler:(nullable VLCMetadataWriterCompletionHandler)completionHandler;
+
+/**
+ * Queue a save of metadata already set through VLCMediaMetaData.
+ * \param media the media to save
+ * \param completionHandler optional, called once the media was saved
+ */
+- (void)saveMedia:(VLCMedia *)media
+completionHandler:(nullable VLCMetadataWriterCompletionHandler)completionHandler;
+
+/**
+ * Queue a save for every media of the array.
+ * \param mediaArray the media to save
+ * \param completionHandler optional, called once per media
+ */
+- (void)saveMediaArray:(NSArray<VLCMedia *> *)mediaArray
+     completionHandler:(nullable VLCMetadataWriterCompletionHandler)completionHandler;
+
+/**
+ * Drop all media that did not start being written. Their completion handlers are not called.
+ */
+- (void)cancelPendingSaves;
+
+@end
+
+NS_ASSUME_NONNULL_END
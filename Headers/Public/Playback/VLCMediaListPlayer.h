@@ -147,6 +147,65 @@ OBJC_VISIBLE
  */
 - (void)playMedia:(VLCMedia *)media;
 
+/**
+ * Play the items of the media list in random order, NO by default.
+ *
+ * Every item plays once before any plays again, with VLCRepeatAllItems a new
+ * order starts once all of them played. next and previous stay O(1) on lists of
+ * any size and walk through a bounded history of the played items. Adding or
+ * removing items while shuffling does not start the order over, moved items
+ * may play again in the current order.
+ * \note turning shuffle off lets the current item finish, list order resumes after it
+ */
+@property (nonatomic, getter=isShuffleEnabled) BOOL shuffleEnabled;
+
+/**
+ * how many played items previous can go back to while shuffling
+ * \note defaults to 100
+ */
+@property (nonatomic) NSUInteger shuffleHistoryLimit;
+
+/* Item transitions */
+/**
+ * Prepare the next item while the current one plays, NO by default.
+ *
+ * Once the current item is within preparationInterval of its end, the next
+ * item is parsed if it is a local file, and its first 4 MiB and last 1 MiB
+ * are read ahead into the system cache. Network media are left untouched,
+ * they are only read by the list player switching to them.
+ * \note this is not gapless playback, the next input is still opened once the
+ * current one ended. Audio and video outputs are kept across items by libvlc,
+ * the transition gap measured below is mostly the opening of the next input.
+ */
+@property (nonatomic) BOOL preparesNextItem;
+
+/**
+ * how long before the end of the current item the next one is prepared, in seconds
+ * \note defaults to 10 seconds
+ */
+@property (nonatomic) NSTimeInterval preparationInterval;
+
+/**
+ * the time between the end of the previous item and the start of the current one, in seconds
+ * \note 0 until a transition happened
+ */
+@property (readonly) NSTimeInterval lastTransitionGap;
+
+/**
+ * the average of all transition gaps since the last reset, in seconds
+ */
+@property (readonly) NSTimeInterval averageTransitionGap;
+
+/**
+ * the number of transitions measured since the last reset
+ */
+@property (readonly) NSUInteger transitionCount;
+
+/**
+ * forget all measured transition gaps
+ */
+- (void)resetTransitionStatistics;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -30,6 +30,7 @@
 #if TARGET_OS_IPHONE
 # import <UIKit/UIImage.h>
 #endif // TARGET_OS_IPHONE
+#import "VLCVideoFrame.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -278,6 +279,30 @@ OBJC_VISIBLE
  */
 @property (strong, nullable) id drawable; /* The videoView or videoLayer */
 
+/**
+ * Delivers the decoded frames to a handler instead of a drawable.
+ *
+ * Frames are decoded in turn into a pool of preallocated buffers. A buffer is not
+ * decoded into again before its frame is recycled, so frames can be read without
+ * tearing. When the handler holds every buffer, new frames are dropped instead of
+ * blocking the decoder.
+ * No window is created, this works on hosts without a display.
+ *
+ * \param handler the block receiving the frames, nil to go back to the drawable
+ * \param pixelFormat the pixel format of the frames
+ * \param size the size of the frames, CGSizeZero for the size of the video,
+ * a dimension of 0 follows the aspect ratio of the video
+ * \param bufferCount the number of buffers of the pool
+ * \param queue the queue the handler is called on, nil for a private serial queue
+ * \note This takes effect at the next video output, set it before playing.
+ * Setting a drawable afterwards removes the handler, the last one set is used.
+ */
+- (void)setVideoFrameHandler:(nullable VLCVideoFrameHandler)handler
+                 pixelFormat:(VLCVideoFramePixelFormat)pixelFormat
+                        size:(CGSize)size
+                 bufferCount:(NSUInteger)bufferCount
+                       queue:(nullable dispatch_queue_t)queue;
+
 /**
  * Set/Get current video aspect ratio.
  *
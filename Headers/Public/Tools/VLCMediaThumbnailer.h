@@ -25,11 +25,40 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
-@class VLCMedia, VLCLibrary;
+@class VLCMedia, VLCLibrary, VLCTime, VLCThumbnailSpriteSheet, VLCThumbnailDiskCache;
 @protocol VLCMediaThumbnailerDelegate;
 
+/**
+ * the ways a thumbnail can be created
+ */
+typedef NS_ENUM(NSUInteger, VLCMediaThumbnailerMode) {
+    VLCMediaThumbnailerModePlayback = 0,        ///< play the media without audio and keep a decoded frame
+    VLCMediaThumbnailerModeThumbnailRequest,    ///< let libvlc decode a single frame, without audio output, video output or clock
+};
+
+/**
+ * the pixel formats a thumbnail can be delivered in
+ */
+typedef NS_ENUM(NSUInteger, VLCMediaThumbnailerPixelFormat) {
+    VLCMediaThumbnailerPixelFormatRGBA = 0,     ///< 8-bit red, green, blue and an unused byte
+    VLCMediaThumbnailerPixelFormatBGRA,         ///< 8-bit blue, green, red and an unused byte
+    VLCMediaThumbnailerPixelFormatI420,         ///< 8-bit YUV 4:2:0, a Y, a U and a V plane
+    VLCMediaThumbnailerPixelFormatNV12,         ///< 8-bit YUV 4:2:0, a Y and an interleaved UV plane
+    VLCMediaThumbnailerPixelFormatGray,         ///< 8-bit luma
+};
+
+/**
+ * the ways the frame of a thumbnail is picked
+ */
+typedef NS_ENUM(NSUInteger, VLCMediaThumbnailerFrameSelection) {
+    VLCMediaThumbnailerFrameSelectionPosition = 0,  ///< keep a frame once the player settled on the snapshot position
+    VLCMediaThumbnailerFrameSelectionScore,         ///< keep the most detailed of a few frames around the snapshot position, skipping black and flat ones
+};
+
 /**
  * a facility allowing you to do thumbnails in an efficient manner
+ * \note Thumbnailers do their work on a private queue and do not need a run loop,
+ * many of them can run at once, from any thread.
  */
 OBJC_VISIBLE
 @interface VLCMediaThumbnailer : NSObject
@@ -56,18 +85,52 @@ OBJC_VISIBLE
  */
 - (void)fetchThumbnail;
 
+/**
+ * Starts creating a sprite sheet of evenly spaced frames in a single playback of the media
+ * \param tileCount the number of frames
+ * \param columns the number of tiles per row of an image
+ * \param rows the number of rows per image, 0 to put all tiles in a single image
+ * \note The tile size follows thumbnailWidth and thumbnailHeight, the mode is ignored.
+ * Seeks go to the nearest keyframe. Once done, the sheet is reported to
+ * mediaThumbnailer:didFinishSpriteSheet:, on time-out the tiles decoded so far
+ * are reported if there are any.
+ */
+- (void)fetchSpriteSheetWithTileCount:(NSUInteger)tileCount columns:(NSUInteger)columns rows:(NSUInteger)rows;
+
 /**
  * delegate object associated with the thumbnailer instance implementing the required protocol
  */
 @property (readwrite, weak, nonatomic, nullable) id<VLCMediaThumbnailerDelegate> delegate;
+/**
+ * the queue the delegate is called on
+ * Set it to a queue of your own when the main thread does not run a dispatch
+ * loop, as in command-line tools and daemons.
+ * You shouldn't change this after -fetchThumbnail
+ * has been called.
+ * @return the delegate queue. Default value nil, meaning the main queue.
+ */
+@property (readwrite, strong, nonatomic, nullable) dispatch_queue_t delegateQueue;
 /**
  * the media object that is being thumbnailed
+ * \note The thumbnailer plays a copy sharing its parsed state, the options of the media are left untouched.
  */
 @property (readwrite, nonatomic) VLCMedia *media;
 /**
  * The thumbnail created for the media object
  */
 @property (readwrite, assign, nonatomic, nullable) CGImageRef thumbnail;
+/**
+ * The pixels of the thumbnail in pixelFormat
+ * Planes follow each other without padding. Rows are thumbnailWidth pixels,
+ * chroma planes have half the width and height of the thumbnail, rounded up.
+ * The thumbnail image reads these bytes, showing only the luma plane of YUV formats.
+ * @return the pixels, nil if the thumbnail was not decoded by a player
+ */
+@property (readonly, nonatomic, nullable) NSData *thumbnailData;
+/**
+ * The sprite sheet created for the media object
+ */
+@property (readonly, nonatomic, nullable) VLCThumbnailSpriteSheet *spriteSheet;
 /**
  * Thumbnail Height
  * You shouldn't change this after -fetchThumbnail
@@ -91,6 +154,70 @@ OBJC_VISIBLE
  * @return snapshot position. Default value 0.3
  */
 @property (readwrite, assign, nonatomic) float snapshotPosition;
+
+/**
+ * How the thumbnail is created
+ * You shouldn't change this after -fetchThumbnail
+ * has been called.
+ * \note With VLCMediaThumbnailerModeThumbnailRequest, the media is not parsed
+ * beforehand. If its video size is not known yet, only the thumbnail height
+ * is applied and the width follows the aspect ratio of the video.
+ * @return the thumbnailing mode. Default value VLCMediaThumbnailerModePlayback.
+ */
+@property (readwrite, assign, nonatomic) VLCMediaThumbnailerMode mode;
+
+/**
+ * Pixel Format
+ * Only used with VLCMediaThumbnailerModePlayback, thumbnail requests and
+ * sprite sheets are always RGB. Frames come from the video output in this
+ * format, when the decoder already produces it they are downscaled with vImage
+ * instead of the scaler of the video output.
+ * You shouldn't change this after -fetchThumbnail
+ * has been called.
+ * @return the pixel format of thumbnailData. Default value VLCMediaThumbnailerPixelFormatRGBA.
+ */
+@property (readwrite, assign, nonatomic) VLCMediaThumbnailerPixelFormat pixelFormat;
+
+/**
+ * Frame Selection
+ * Only used with VLCMediaThumbnailerModePlayback.
+ * You shouldn't change this after -fetchThumbnail
+ * has been called.
+ * @return the frame selection. Default value VLCMediaThumbnailerFrameSelectionPosition.
+ */
+@property (readwrite, assign, nonatomic) VLCMediaThumbnailerFrameSelection frameSelection;
+
+/**
+ * Candidate Frame Count
+ * The number of frames compared with VLCMediaThumbnailerFrameSelectionScore,
+ * spread over 2% of the media each and centered on the snapshot position.
+ * Every candidate costs a seek to the nearest keyframe.
+ * You shouldn't change this after -fetchThumbnail
+ * has been called.
+ * @return the candidate frame count. Default value 5.
+ */
+@property (readwrite, assign, nonatomic) NSUInteger candidateFrameCount;
+
+/**
+ * Snapshot Time
+ * Only used with VLCMediaThumbnailerModeThumbnailRequest, it takes precedence
+ * over snapshotPosition when set.
+ * You shouldn't change this after -fetchThumbnail
+ * has been called.
+ * @return snapshot time. Default value nil.
+ */
+@property (readwrite, strong, nonatomic, nullable) VLCTime *snapshotTime;
+
+/**
+ * Disk Cache
+ * When set, -fetchThumbnail first looks the thumbnail up in the cache and
+ * reports it without creating a player if found. New thumbnails are stored
+ * in it. Sprite sheets, thumbnails at a snapshotTime, thumbnails in
+ * another pixelFormat than RGBA and thumbnails picked by
+ * VLCMediaThumbnailerFrameSelectionScore are not cached.
+ * @return the disk cache. Default value nil.
+ */
+@property (readwrite, strong, nonatomic, nullable) VLCThumbnailDiskCache *diskCache;
 @end
 
 /**
@@ -110,6 +237,13 @@ OBJC_VISIBLE
  * \param thumbnail the thumbnail that was created
  */
 - (void)mediaThumbnailer:(VLCMediaThumbnailer *)mediaThumbnailer didFinishThumbnail:(CGImageRef)thumbnail;
+@optional
+/**
+ * called when the thumbnailer did successfully create a sprite sheet
+ * \param mediaThumbnailer the thumbnailer instance that was successful
+ * \param spriteSheet the sprite sheet that was created
+ */
+- (void)mediaThumbnailer:(VLCMediaThumbnailer *)mediaThumbnailer didFinishSpriteSheet:(VLCThumbnailSpriteSheet *)spriteSheet;
 @end
 
 NS_ASSUME_NONNULL_END
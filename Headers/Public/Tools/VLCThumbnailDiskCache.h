@@ -0,0 +1,127 @@
+/*****************************************************************************
+ * VLCThumbnailDiskCache.h: VLCKit.framework VLCThumbnailDiskCache header
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#import <Foundation/Foundation.h>
+#import <CoreGraphics/CoreGraphics.h>
+
+@class VLCMedia;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * An on-disk cache of thumbnails, addressed by the content of the media.
+ *
+ * Keys combine a fingerprint of the media, its size plus a hash of a few
+ * sampled chunks, with the thumbnail size and position. A file that is
+ * renamed or moved therefore keeps its thumbnails, while a file that is
+ * replaced does not reuse stale ones. Thumbnails are stored as PNG files
+ * and evicted least recently used first once they exceed byteLimit.
+ * All methods are thread-safe.
+ * \see VLCMediaThumbnailer.diskCache
+ */
+OBJC_VISIBLE
+@interface VLCThumbnailDiskCache : NSObject
+
+/**
+ * a cache in the caches directory of the user, limited to 256 MiB
+ */
+@property (class, readonly) VLCThumbnailDiskCache *sharedCache;
+
+/**
+ * \param directoryURL the directory to keep the thumbnails in, created if needed
+ * \param byteLimit the maximum number of bytes of thumbnails kept on disk
+ * \note files already in the directory are accounted for and evicted like new ones
+ */
+- (instancetype)initWithDirectoryURL:(NSURL *)directoryURL byteLimit:(NSUInteger)byteLimit NS_DESIGNATED_INITIALIZER;
+
+/**
+ * the directory the thumbnails are kept in
+ */
+@property (nonatomic, readonly) NSURL *directoryURL;
+
+/**
+ * maximum number of bytes of thumbnails kept on disk
+ * \note lowering the limit evicts files in the background
+ */
+@property (atomic) NSUInteger byteLimit;
+
+/**
+ * number of bytes of thumbnails currently on disk
+ */
+@property (atomic, readonly) NSUInteger totalBytes;
+
+/**
+ * number of thumbnails currently on disk
+ */
+@property (atomic, readonly) NSUInteger count;
+
+/**
+ * number of lookups that found a thumbnail since the last reset of the statistics
+ */
+@property (atomic, readonly) NSUInteger hitCount;
+
+/**
+ * number of lookups that found nothing since the last reset of the statistics
+ */
+@property (atomic, readonly) NSUInteger missCount;
+
+/**
+ * Computes the key of a thumbnail.
+ * \param media the thumbnailed media, local files are fingerprinted by content, other media by URL
+ * \param size the requested thumbnail size
+ * \param position the requested snapshot position
+ * \return the key, nil if the media has no URL or its file can't be read
+ * \note this reads a few chunks of local files, avoid calling it on the main thread
+ */
+- (nullable NSString *)keyForMedia:(VLCMedia *)media size:(CGSize)size position:(float)position;
+
+/**
+ * Loads a thumbnail and counts a hit or a miss.
+ * \param key a key returned by keyForMedia:size:position:
+ * \return the thumbnail to release with CGImageRelease, NULL if it is not cached
+ */
+- (nullable CGImageRef)copyImageForKey:(NSString *)key CF_RETURNS_RETAINED;
+
+/**
+ * Stores a thumbnail in the background, replacing any previous one with the same key.
+ * \param image the thumbnail
+ * \param key a key returned by keyForMedia:size:position:
+ */
+- (void)storeImage:(CGImageRef)image forKey:(NSString *)key;
+
+/**
+ * delete all thumbnails in the background
+ */
+- (void)removeAllImages;
+
+/**
+ * reset hitCount and missCount
+ */
+- (void)resetStatistics;
+
++ (instancetype)new NS_UNAVAILABLE;
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,137 @@
+/*****************************************************************************
+ * VLCThumbnailQueue.h: VLCKit.framework VLCThumbnailQueue header
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#import <Foundation/Foundation.h>
+#import <CoreGraphics/CoreGraphics.h>
+
+@class VLCMedia, VLCLibrary;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * called on the completion queue once a media was thumbnailed
+ * \param media the thumbnailed media
+ * \param thumbnail the thumbnail, NULL if the media has no video or timed out
+ */
+typedef void (^VLCThumbnailQueueCompletionHandler)(VLCMedia *media, CGImageRef _Nullable thumbnail);
+
+/**
+ * Thumbnails many media with a bounded number of players.
+ *
+ * Unlike VLCMediaThumbnailer, the players and their frame buffers are created
+ * once and reused for every media, and the media does not need to be parsed
+ * beforehand. The thumbnail size is derived from the first decoded picture.
+ * All methods are thread-safe.
+ */
+OBJC_VISIBLE
+@interface VLCThumbnailQueue : NSObject
+
+/**
+ * a queue on the shared library using one player per active processor
+ */
+- (instancetype)init;
+
+/**
+ * \param library the library to create the players with, the shared library if nil
+ * \param maximumConcurrentThumbnails the number of players, at least 1
+ */
+- (instancetype)initWithLibrary:(nullable VLCLibrary *)library
+    maximumConcurrentThumbnails:(NSUInteger)maximumConcurrentThumbnails NS_DESIGNATED_INITIALIZER;
+
+/**
+ * the library the players are created with
+ */
+@property (nonatomic, readonly) VLCLibrary *library;
+
+/**
+ * the number of media thumbnailed in parallel, which is also the number of players kept around
+ */
+@property (nonatomic, readonly) NSUInteger maximumConcurrentThumbnails;
+
+/**
+ * Size the thumbnails are scaled to, keeping the aspect ratio of the video.
+ * The smaller side of the video matches the box, the other one may exceed it.
+ * Applies to media queued afterwards. Default value 320x240.
+ */
+@property (atomic) CGSize thumbnailSize;
+
+/**
+ * Position of the snapshot, between 0 and 1.
+ * Applies to media queued afterwards. Default value 0.3.
+ */
+@property (atomic) float snapshotPosition;
+
+/**
+ * queue the completion handlers are called on, the main queue if nil
+ */
+@property (atomic, strong, nullable) dispatch_queue_t completionQueue;
+
+/**
+ * number of media waiting for a player, excluding the ones being thumbnailed
+ */
+@property (atomic, readonly) NSUInteger pendingCount;
+
+/**
+ * number of thumbnails created since the last reset of the statistics
+ */
+@property (atomic, readonly) NSUInteger completedCount;
+
+/**
+ * number of media that failed or timed out since the last reset of the statistics
+ */
+@property (atomic, readonly) NSUInteger failedCount;
+
+/**
+ * thumbnails created per second of activity, idle periods are not counted
+ */
+@property (atomic, readonly) double thumbnailsPerSecond;
+
+/**
+ * Queue a media.
+ * \param media the media to thumbnail
+ * \param completionHandler optional, called once the media was thumbnailed
+ */
+- (void)thumbnailMedia:(VLCMedia *)media
+     completionHandler:(nullable VLCThumbnailQueueCompletionHandler)completionHandler;
+
+/**
+ * Queue every media of the array.
+ * \param mediaArray the media to thumbnail
+ * \param completionHandler optional, called once per media
+ */
+- (void)thumbnailMediaArray:(NSArray<VLCMedia *> *)mediaArray
+          completionHandler:(nullable VLCThumbnailQueueCompletionHandler)completionHandler;
+
+/**
+ * Drop all media that did not start being thumbnailed. Their completion handlers are not called.
+ */
+- (void)cancelPendingThumbnails;
+
+/**
+ * reset completedCount, failedCount and thumbnailsPerSecond
+ */
+- (void)resetStatistics;
+
+@end
+
+NS_ASSUME_NONNULL_END
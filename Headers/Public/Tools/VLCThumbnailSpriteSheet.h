@@ -0,0 +1,111 @@
+/*****************************************************************************
+ * VLCThumbnailSpriteSheet.h: VLCKit.framework VLCThumbnailSpriteSheet header
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#import <Foundation/Foundation.h>
+#import <CoreGraphics/CoreGraphics.h>
+
+@class VLCTime;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Evenly spaced frames of a media packed into tiled images, for scrubbing previews.
+ *
+ * Tile i shows the middle of the i-th equal part of the media and covers that
+ * whole part. Tiles are laid out left to right, then top to bottom, and
+ * continue on the next image once an image is full.
+ * \see -[VLCMediaThumbnailer fetchSpriteSheetWithTileCount:columns:rows:]
+ */
+OBJC_VISIBLE
+@interface VLCThumbnailSpriteSheet : NSObject
+
+/**
+ * the number of tiles, tiles that could not be decoded in time stay black
+ */
+@property (nonatomic, readonly) NSUInteger tileCount;
+
+/**
+ * number of tiles per row of an image
+ */
+@property (nonatomic, readonly) NSUInteger columns;
+
+/**
+ * number of rows of a full image, the last image may have fewer
+ */
+@property (nonatomic, readonly) NSUInteger rows;
+
+/**
+ * size of every tile in pixels
+ */
+@property (nonatomic, readonly) CGSize tileSize;
+
+/**
+ * the length of the media the tiles are spread over
+ */
+@property (nonatomic, readonly) VLCTime *duration;
+
+/**
+ * number of images holding the tiles
+ */
+@property (nonatomic, readonly) NSUInteger imageCount;
+
+/**
+ * \param index the image index, lower than imageCount
+ * \return the image, NULL if the index is out of range
+ */
+- (nullable CGImageRef)imageAtIndex:(NSUInteger)index;
+
+/**
+ * \param time a time of the media
+ * \return the tile covering the time, NSNotFound if the time is out of the media
+ */
+- (NSUInteger)tileIndexForTime:(VLCTime *)time;
+
+/**
+ * \param tileIndex the tile index, lower than tileCount
+ * \param imageIndex optional, returns the index of the image holding the tile
+ * \return the pixel rectangle of the tile in its image, CGRectNull if the index is out of range
+ */
+- (CGRect)rectOfTileAtIndex:(NSUInteger)tileIndex imageIndex:(nullable NSUInteger *)imageIndex;
+
+/**
+ * a WebVTT thumbnail track with one cue per tile, pointing at its rectangle through a media fragment
+ * \param imageNames the names or URLs the images are published under, one per image
+ * \return the track, nil if there are fewer names than images
+ */
+- (nullable NSString *)WebVTTStringWithImageNames:(NSArray<NSString *> *)imageNames;
+
+/**
+ * a JSON array with one object per tile, holding its start and end in seconds,
+ * its image name and its x, y, width and height in pixels
+ * \param imageNames the names or URLs the images are published under, one per image
+ * \return the UTF-8 encoded JSON, nil if there are fewer names than images
+ */
+- (nullable NSData *)JSONDataWithImageNames:(NSArray<NSString *> *)imageNames;
+
++ (instancetype)new NS_UNAVAILABLE;
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -29,11 +29,20 @@
 #import <VLCKit/VLCMedia.h>
 #import <VLCKit/VLCMediaDiscoverer.h>
 #import <VLCKit/VLCMediaList.h>
+#import <VLCKit/VLCMediaListView.h>
 #import <VLCKit/VLCMediaPlayer.h>
 #import <VLCKit/VLCAudioEqualizer.h>
 #import <VLCKit/VLCMediaListPlayer.h>
 #import <VLCKit/VLCMediaThumbnailer.h>
+#import <VLCKit/VLCThumbnailQueue.h>
+#import <VLCKit/VLCThumbnailSpriteSheet.h>
+#import <VLCKit/VLCThumbnailDiskCache.h>
+#import <VLCKit/VLCVideoFrame.h>
 #import <VLCKit/VLCMediaMetaData.h>
+#import <VLCKit/VLCMediaStatsSampler.h>
+#import <VLCKit/VLCMediaOptionTemplate.h>
+#import <VLCKit/VLCArtworkCache.h>
+#import <VLCKit/VLCMetadataWriter.h>
 #import <VLCKit/VLCTime.h>
 #import <VLCKit/VLCFilter.h>
 #import <VLCKit/VLCAdjustFilter.h>
@@ -82,6 +91,16 @@
 @class VLCFilterParameter;
 @class VLCAdjustFilter;
 @class VLCMediaMetaData;
+@class VLCMediaMetaDataSnapshot;
+@class VLCMediaStatsSampler;
+@class VLCMediaOptionTemplate;
+@class VLCArtworkCache;
+@class VLCMetadataWriter;
+@class VLCMediaListView;
+@class VLCThumbnailQueue;
+@class VLCThumbnailSpriteSheet;
+@class VLCThumbnailDiskCache;
+@class VLCVideoFrame;
 @class VLCConsoleLogger;
 @class VLCFileLogger;
 @class VLCLogMessageFormatter;
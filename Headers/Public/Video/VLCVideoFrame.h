@@ -0,0 +1,116 @@
+/*****************************************************************************
+ * VLCVideoFrame.h: VLCKit.framework VLCVideoFrame header
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * the pixel formats video frames can be delivered in
+ */
+typedef NS_ENUM(NSUInteger, VLCVideoFramePixelFormat) {
+    VLCVideoFramePixelFormatRGBA = 0,   ///< 8-bit red, green, blue and an unused byte
+    VLCVideoFramePixelFormatBGRA,       ///< 8-bit blue, green, red and an unused byte
+    VLCVideoFramePixelFormatI420,       ///< 8-bit YUV 4:2:0, a Y, a U and a V plane
+    VLCVideoFramePixelFormatNV12,       ///< 8-bit YUV 4:2:0, a Y and an interleaved UV plane
+    VLCVideoFramePixelFormatGray,       ///< 8-bit luma
+};
+
+/**
+ * A decoded video frame, held in a buffer of the pool of its media player.
+ *
+ * The buffer is not written to until the frame is recycled, so frames can be
+ * read at leisure. While the handler holds every buffer of the pool, new
+ * frames are dropped instead of waiting for one.
+ * \see -[VLCMediaPlayer setVideoFrameHandler:pixelFormat:size:bufferCount:queue:]
+ */
+OBJC_VISIBLE
+@interface VLCVideoFrame : NSObject
+
+/**
+ * the pixel format of the planes
+ */
+@property (nonatomic, readonly) VLCVideoFramePixelFormat pixelFormat;
+
+/**
+ * width of the frame in pixels
+ */
+@property (nonatomic, readonly) unsigned width;
+
+/**
+ * height of the frame in pixels
+ */
+@property (nonatomic, readonly) unsigned height;
+
+/**
+ * number of planes, 1 for RGB and gray, 2 for NV12 and 3 for I420
+ */
+@property (nonatomic, readonly) NSUInteger planeCount;
+
+/**
+ * index of the buffer of the pool holding the frame
+ */
+@property (nonatomic, readonly) NSUInteger bufferIndex;
+
+/**
+ * number of frames dropped since the previous frame, because no buffer was free
+ */
+@property (nonatomic, readonly) NSUInteger droppedFrameCount;
+
+/**
+ * \param plane the plane index, lower than planeCount
+ * \return the first byte of the plane, NULL if the index is out of range or the frame was recycled
+ */
+- (nullable const void *)bytesOfPlane:(NSUInteger)plane NS_RETURNS_INNER_POINTER;
+
+/**
+ * \param plane the plane index, lower than planeCount
+ * \return bytes per line of the plane, 0 if the index is out of range
+ */
+- (size_t)pitchOfPlane:(NSUInteger)plane;
+
+/**
+ * \param plane the plane index, lower than planeCount
+ * \return number of lines of the plane, 0 if the index is out of range
+ */
+- (size_t)linesOfPlane:(NSUInteger)plane;
+
+/**
+ * Gives the buffer back to the pool, the planes must not be read afterwards.
+ * \note Done when the frame is deallocated at the latest, recycle frames as soon
+ * as possible for the decoder not to run out of buffers.
+ */
+- (void)recycle;
+
++ (instancetype)new NS_UNAVAILABLE;
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+/**
+ * receives decoded video frames
+ * \param frame the frame, to recycle once done with it
+ */
+typedef void (^VLCVideoFrameHandler)(VLCVideoFrame *frame);
+
+NS_ASSUME_NONNULL_END
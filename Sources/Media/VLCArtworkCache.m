@@ -0,0 +1,379 @@
+/*****************************************************************************
+ * VLCArtworkCache.m: VLCKit.framework VLCArtworkCache implementation
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#import <VLCArtworkCache.h>
+#import <ImageIO/ImageIO.h>
+#if TARGET_OS_IPHONE
+    #if !TARGET_OS_WATCH
+        #import <UIKit/UIApplication.h>
+    #endif
+    #if !(TARGET_OS_WATCH || (defined(TARGET_OS_VISION) && TARGET_OS_VISION))
+        #import <UIKit/UIScreen.h>
+    #endif
+#else
+#import <AppKit/NSScreen.h>
+#endif
+
+#include <os/lock.h>
+
+static const NSUInteger kDefaultTotalCostLimit = 32 * 1024 * 1024;
+static const NSUInteger kMaximumConcurrentDecodes = 4;
+
+typedef void (^VLCArtworkCompletionHandler)(VLCPlatformImage * _Nullable image);
+
+/**
+ * One decoded image, linked in recency order. The dictionary of the cache
+ * owns the entries, the list links are therefore not retaining.
+ */
+@interface VLCArtworkCacheEntry : NSObject
+{
+@public
+    NSString *_key;
+    VLCPlatformImage *_image;
+    NSUInteger _cost;
+    __unsafe_unretained VLCArtworkCacheEntry *_previous;
+    __unsafe_unretained VLCArtworkCacheEntry *_next;
+}
+@end
+
+@implementation VLCArtworkCacheEntry
+@end
+
+@implementation VLCArtworkCache
+{
+    os_unfair_lock _lock;               ///< Protects everything below
+    NSMutableDictionary<NSString *, VLCArtworkCacheEntry *> *_entries;
+    __unsafe_unretained VLCArtworkCacheEntry *_head;    ///< Most recently used
+    __unsafe_unretained VLCArtworkCacheEntry *_tail;    ///< Least recently used
+    NSUInteger _totalCost;
+    NSUInteger _totalCostLimit;
+    NSMutableDictionary<NSString *, NSMutableArray<VLCArtworkCompletionHandler> *> *_pendingRequests;
+    dispatch_queue_t _decodeQueue;
+    NSMutableArray<dispatch_block_t> *_waitingDecodes;  ///< Started in order once a decode slot is free
+    NSUInteger _runningDecodes;
+    CGFloat _scale;
+}
+
++ (VLCArtworkCache *)sharedCache
+{
+    static VLCArtworkCache *sharedCache;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedCache = [[VLCArtworkCache alloc] init];
+    });
+    return sharedCache;
+}
+
+- (instancetype)init
+{
+    if (self = [super init]) {
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _entries = [NSMutableDictionary dictionary];
+        _pendingRequests = [NSMutableDictionary dictionary];
+        _totalCostLimit = kDefaultTotalCostLimit;
+        _waitingDecodes = [NSMutableArray array];
+#if TARGET_OS_IPHONE
+    #if !(TARGET_OS_WATCH || (defined(TARGET_OS_VISION) && TARGET_OS_VISION))
+        _scale = UIScreen.mainScreen.scale;
+    #else
+        // there is no main screen to ask
+        _scale = 1.;
+    #endif
+#else
+        _scale = NSScreen.mainScreen.backingScaleFactor;
+#endif
+        if (_scale < 1.)
+            _scale = 1.;
+        dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_CONCURRENT,
+                                                                             QOS_CLASS_UTILITY,
+                                                                             0);
+        _decodeQueue = dispatch_queue_create("org.videolan.VLCArtworkCache.decode", attr);
+#if TARGET_OS_IPHONE && !TARGET_OS_WATCH
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(removeAllImages)
+                                                     name:UIApplicationDidReceiveMemoryWarningNotification
+                                                   object:nil];
+#endif
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+#if TARGET_OS_IPHONE && !TARGET_OS_WATCH
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+#endif
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@ %p>, count: %lu, cost: %lu/%lu", [self class], self, (unsigned long)self.count, (unsigned long)self.totalCost, (unsigned long)self.totalCostLimit];
+}
+
+#pragma mark - accounting
+
+- (NSUInteger)totalCost
+{
+    os_unfair_lock_lock(&_lock);
+    const NSUInteger totalCost = _totalCost;
+    os_unfair_lock_unlock(&_lock);
+    return totalCost;
+}
+
+- (NSUInteger)count
+{
+    os_unfair_lock_lock(&_lock);
+    const NSUInteger count = _entries.count;
+    os_unfair_lock_unlock(&_lock);
+    return count;
+}
+
+- (NSUInteger)totalCostLimit
+{
+    os_unfair_lock_lock(&_lock);
+    const NSUInteger totalCostLimit = _totalCostLimit;
+    os_unfair_lock_unlock(&_lock);
+    return totalCostLimit;
+}
+
+- (void)setTotalCostLimit:(NSUInteger)totalCostLimit
+{
+    os_unfair_lock_lock(&_lock);
+    _totalCostLimit = totalCostLimit;
+    [self lockedTrimToCostLimit];
+    os_unfair_lock_unlock(&_lock);
+}
+
+- (CGFloat)scale
+{
+    os_unfair_lock_lock(&_lock);
+    const CGFloat scale = _scale;
+    os_unfair_lock_unlock(&_lock);
+    return scale;
+}
+
+- (void)setScale:(CGFloat)scale
+{
+    os_unfair_lock_lock(&_lock);
+    _scale = MAX(scale, 1.);
+    os_unfair_lock_unlock(&_lock);
+}
+
+- (void)removeAllImages
+{
+    os_unfair_lock_lock(&_lock);
+    [_entries removeAllObjects];
+    _head = _tail = nil;
+    _totalCost = 0;
+    os_unfair_lock_unlock(&_lock);
+}
+
+#pragma mark - lookup
+
+static NSString *CacheKey(NSURL *url, CGSize size, CGFloat scale)
+{
+    return [NSString stringWithFormat:@"%lux%lu@%g|%@", (unsigned long)size.width, (unsigned long)size.height, scale, url.absoluteString];
+}
+
+- (nullable VLCPlatformImage *)cachedImageForURL:(NSURL *)url size:(CGSize)size
+{
+    os_unfair_lock_lock(&_lock);
+    NSString *key = CacheKey(url, size, _scale);
+    VLCArtworkCacheEntry *entry = _entries[key];
+    if (entry)
+        [self lockedMoveToHead:entry];
+    VLCPlatformImage *image = entry ? entry->_image : nil;
+    os_unfair_lock_unlock(&_lock);
+    return image;
+}
+
+- (void)loadImageForURL:(NSURL *)url
+                   size:(CGSize)size
+      completionHandler:(VLCArtworkCompletionHandler)completionHandler
+{
+    VLCPlatformImage *image = [self cachedImageForURL:url size:size];
+    if (image || !url.isFileURL || size.width < 1. || size.height < 1.) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completionHandler(image);
+        });
+        return;
+    }
+
+    os_unfair_lock_lock(&_lock);
+    const CGFloat scale = _scale;
+    NSString *key = CacheKey(url, size, scale);
+    NSMutableArray<VLCArtworkCompletionHandler> *pending = _pendingRequests[key];
+    const BOOL alreadyDecoding = pending != nil;
+    if (!pending)
+        _pendingRequests[key] = pending = [NSMutableArray array];
+    [pending addObject:completionHandler];
+    os_unfair_lock_unlock(&_lock);
+
+    if (alreadyDecoding)
+        return;
+
+    [self enqueueDecode:^{
+        NSUInteger cost = 0;
+        VLCPlatformImage *decodedImage = [VLCArtworkCache decodeImageAtURL:url size:size scale:scale cost:&cost];
+
+        os_unfair_lock_lock(&self->_lock);
+        if (decodedImage)
+            [self lockedInsertImage:decodedImage cost:cost forKey:key];
+        NSArray<VLCArtworkCompletionHandler> *handlers = self->_pendingRequests[key];
+        [self->_pendingRequests removeObjectForKey:key];
+        os_unfair_lock_unlock(&self->_lock);
+
+        dispatch_async(dispatch_get_main_queue(), ^{
+            for (VLCArtworkCompletionHandler handler in handlers)
+                handler(decodedImage);
+        });
+    }];
+}
+
+/* bounds the decodes in flight, a list scrolling by does not start a thread per cell */
+- (void)enqueueDecode:(dispatch_block_t)decode
+{
+    os_unfair_lock_lock(&_lock);
+    const BOOL start = _runningDecodes < kMaximumConcurrentDecodes;
+    if (start)
+        _runningDecodes++;
+    else
+        [_waitingDecodes addObject:decode];
+    os_unfair_lock_unlock(&_lock);
+
+    if (start)
+        [self runDecode:decode];
+}
+
+- (void)runDecode:(dispatch_block_t)decode
+{
+    dispatch_async(_decodeQueue, ^{
+        decode();
+
+        os_unfair_lock_lock(&self->_lock);
+        dispatch_block_t next = self->_waitingDecodes.firstObject;
+        if (next)
+            [self->_waitingDecodes removeObjectAtIndex:0];
+        else
+            self->_runningDecodes--;
+        os_unfair_lock_unlock(&self->_lock);
+
+        if (next)
+            [self runDecode:next];
+    });
+}
+
+#pragma mark - decoding
+
++ (nullable VLCPlatformImage *)decodeImageAtURL:(NSURL *)url size:(CGSize)size scale:(CGFloat)scale cost:(NSUInteger *)cost
+{
+    CGImageSourceRef source = CGImageSourceCreateWithURL((__bridge CFURLRef)url, NULL);
+    if (!source)
+        return nil;
+
+    // let ImageIO subsample while decoding instead of scaling a full size bitmap
+    NSDictionary *options = @{
+        (__bridge NSString *)kCGImageSourceCreateThumbnailFromImageAlways : @YES,
+        (__bridge NSString *)kCGImageSourceCreateThumbnailWithTransform : @YES,
+        (__bridge NSString *)kCGImageSourceShouldCacheImmediately : @YES,
+        (__bridge NSString *)kCGImageSourceThumbnailMaxPixelSize : @(ceil(MAX(size.width, size.height) * scale)),
+    };
+    CGImageRef cgImage = CGImageSourceCreateThumbnailAtIndex(source, 0, (__bridge CFDictionaryRef)options);
+    CFRelease(source);
+    if (!cgImage)
+        return nil;
+
+    *cost = CGImageGetBytesPerRow(cgImage) * CGImageGetHeight(cgImage);
+#if TARGET_OS_IPHONE
+    VLCPlatformImage *image = [UIImage imageWithCGImage:cgImage scale:scale orientation:UIImageOrientationUp];
+#else
+    NSSize pointSize = NSMakeSize(CGImageGetWidth(cgImage) / scale, CGImageGetHeight(cgImage) / scale);
+    VLCPlatformImage *image = [[NSImage alloc] initWithCGImage:cgImage size:pointSize];
+#endif
+    CGImageRelease(cgImage);
+    return image;
+}
+
+#pragma mark - LRU list, called with the lock held
+
+- (void)lockedInsertImage:(VLCPlatformImage *)image cost:(NSUInteger)cost forKey:(NSString *)key
+{
+    VLCArtworkCacheEntry *entry = _entries[key];
+    if (entry) {
+        _totalCost -= entry->_cost;
+        [self lockedUnlink:entry];
+    } else {
+        entry = [[VLCArtworkCacheEntry alloc] init];
+        entry->_key = key;
+        _entries[key] = entry;
+    }
+    entry->_image = image;
+    entry->_cost = cost;
+    _totalCost += cost;
+    [self lockedLinkAtHead:entry];
+    [self lockedTrimToCostLimit];
+}
+
+- (void)lockedTrimToCostLimit
+{
+    while (_totalCost > _totalCostLimit && _tail) {
+        VLCArtworkCacheEntry *entry = _tail;
+        _totalCost -= entry->_cost;
+        [self lockedUnlink:entry];
+        [_entries removeObjectForKey:entry->_key];
+    }
+}
+
+- (void)lockedMoveToHead:(VLCArtworkCacheEntry *)entry
+{
+    if (_head == entry)
+        return;
+    [self lockedUnlink:entry];
+    [self lockedLinkAtHead:entry];
+}
+
+- (void)lockedLinkAtHead:(VLCArtworkCacheEntry *)entry
+{
+    entry->_previous = nil;
+    entry->_next = _head;
+    if (_head)
+        _head->_previous = entry;
+    _head = entry;
+    if (!_tail)
+        _tail = entry;
+}
+
+- (void)lockedUnlink:(VLCArtworkCacheEntry *)entry
+{
+    if (entry->_previous)
+        entry->_previous->_next = entry->_next;
+    else
+        _head = entry->_next;
+    if (entry->_next)
+        entry->_next->_previous = entry->_previous;
+    else
+        _tail = entry->_previous;
+    entry->_previous = entry->_next = nil;
+}
+
+@end
@@ -34,6 +34,7 @@
 #import <VLCEventsHandler.h>
 #import <vlc/libvlc.h>
 #import <sys/sysctl.h> // for sysctlbyname
+#import <os/lock.h>
 
 /* Notification Messages */
 NSNotificationName const VLCMediaMetaChangedNotification = @"VLCMediaMetaChangedNotification";
@@ -98,12 +99,25 @@ void close_cb(void *opaque) {
     _Nullable id            _userData;              /// libvlc_media_user_data
     VLCEventsHandler*       _eventsHandler;          /// handles libvlc callbacks
     VLCMediaMetaData *_metaData;
+
+    os_unfair_lock          _urlLock;               ///< Protects the lazily resolved URL
+    BOOL                    _urlResolved;           ///< YES once the MRL was fetched
+    NSURL                   *_url;
+
+    os_unfair_lock          _optionsLock;           ///< Protects the recorded options
+    NSMutableArray<NSString *> *_libVLCOptions;     ///< Options added through our API, libvlc cannot report them
+
+    os_unfair_lock          _tracksCacheLock;       ///< Protects the track caches below
+    NSUInteger              _tracksCacheGeneration; ///< Bumped on every invalidation
+    NSArray<VLCMediaTrack *> *_tracksCache[3];      ///< Per-type track wrappers (audio, video, text)
+    NSArray<VLCMediaTrack *> *_tracksInformationCache;
 }
 
 /* Make our properties internally readwrite */
 @property (nonatomic, readwrite, strong, nullable) VLCMediaList * subitems;
 
 - (void)parseIfNeeded;
+- (nullable NSURL *)resolveURL;
 
 /* Callback Methods */
 - (void)parsedChanged;
@@ -287,7 +301,19 @@ static const struct event_handler_entry {
 
 - (NSString *)description
 {
-    return [NSString stringWithFormat:@"<%@ %p>, md: %p, url: %@", [self class], self, p_md, [[_url absoluteString] stringByRemovingPercentEncoding]];
+    return [NSString stringWithFormat:@"<%@ %p>, md: %p, url: %@", [self class], self, p_md, [[self.url absoluteString] stringByRemovingPercentEncoding]];
+}
+
+- (nullable NSURL *)url
+{
+    os_unfair_lock_lock(&_urlLock);
+    if (!_urlResolved) {
+        _url = [self resolveURL];
+        _urlResolved = YES;
+    }
+    NSURL *url = _url;
+    os_unfair_lock_unlock(&_urlLock);
+    return url;
 }
 
 - (NSComparisonResult)compare:(nullable VLCMedia *)media
@@ -387,16 +413,14 @@ static const struct event_handler_entry {
 - (void)addOption:(NSString *)option
 {
     libvlc_media_add_option(p_md, [option UTF8String]);
+    [self recordLibVLCOptions:@[option]];
 }
 
 - (void)addOptions:(NSDictionary*)options
 {
-    [options enumerateKeysAndObjectsUsingBlock:^(NSString *key, id obj, BOOL *stop) {
-        if (![obj isKindOfClass:[NSNull class]])
-            libvlc_media_add_option(p_md, [[NSString stringWithFormat:@"%@=%@", key, obj] UTF8String]);
-        else
-            libvlc_media_add_option(p_md, [key UTF8String]);
-    }];
+    VLCMediaOptionTemplate *optionTemplate = [[VLCMediaOptionTemplate alloc] initWithOptions:options];
+    [optionTemplate applyToLibVLCMediaDescriptor:p_md];
+    [self recordLibVLCOptions:optionTemplate.optionStrings];
 }
 
 - (int)storeCookie:(NSString *)cookie
@@ -455,25 +479,25 @@ static const struct event_handler_entry {
 
 - (NSArray<VLCMediaTrack *> *)tracksInformation
 {
-    NSMutableArray<VLCMediaTrack *> *array = @[].mutableCopy;
-    
+    os_unfair_lock_lock(&_tracksCacheLock);
+    NSArray<VLCMediaTrack *> *tracksInformation = _tracksInformationCache;
+    const NSUInteger generation = _tracksCacheGeneration;
+    os_unfair_lock_unlock(&_tracksCacheLock);
+    if (tracksInformation)
+        return tracksInformation;
+
     // 3 = (libvlc_track_audio = 0 | libvlc_track_video = 1 | libvlc_track_text = 2)
-    for (libvlc_track_type_t type = 0; type < 3; type++) {
-        libvlc_media_tracklist_t *tracklist = libvlc_media_get_tracklist(p_md, type);
-        if (!tracklist) continue;
-        
-        size_t tracklistCount = libvlc_media_tracklist_count(tracklist);
-        for (size_t index = 0; index < tracklistCount; index++) {
-            libvlc_media_track_t *track = libvlc_media_tracklist_at(tracklist, index);
-            VLCMediaTrack *info = [[VLCMediaTrack alloc] initWithMediaTrack: track];
-            if (info)
-                [array addObject: info];
-        }
-        
-        libvlc_media_tracklist_delete(tracklist);
-    }
-    
-    return array;
+    NSMutableArray<VLCMediaTrack *> *array = @[].mutableCopy;
+    for (libvlc_track_type_t type = 0; type < 3; type++)
+        [array addObjectsFromArray: [self _tracksForType: type]];
+    tracksInformation = [array copy];
+
+    os_unfair_lock_lock(&_tracksCacheLock);
+    if (generation == _tracksCacheGeneration && !_tracksInformationCache)
+        _tracksInformationCache = tracksInformation;
+    os_unfair_lock_unlock(&_tracksCacheLock);
+
+    return tracksInformation;
 }
 
 - (nullable id)userData
@@ -493,21 +517,8 @@ static const struct event_handler_entry {
  */
 - (void)initInternalMediaDescriptor
 {
-    char * p_url = libvlc_media_get_mrl( p_md );
-    if (!p_url)
-        return;
-
-    NSString *urlString = @(p_url);
-    free(p_url);
-    
-    if (!urlString)
-        return;
-    
-    /* Attempt to interpret as a file path then */
-    _url = [NSURL URLWithString: urlString] ?: [NSURL fileURLWithPath: urlString];
-    if (!_url)
-        return;
-
+    /* The URL is resolved on first access, see -url. Wrappers created from
+     * events or while expanding playlists usually never read it. */
 
     /* We bind each event to the handler defined in the table above. */
     libvlc_event_manager_t * p_em = libvlc_media_event_manager(p_md);
@@ -527,6 +538,22 @@ static const struct event_handler_entry {
     }
 }
 
+- (nullable NSURL *)resolveURL
+{
+    char * p_url = libvlc_media_get_mrl( p_md );
+    if (!p_url)
+        return nil;
+
+    NSString *urlString = @(p_url);
+    free(p_url);
+
+    if (!urlString)
+        return nil;
+
+    /* Attempt to interpret as a file path then */
+    return [NSURL URLWithString: urlString] ?: [NSURL fileURLWithPath: urlString];
+}
+
 - (void)parseIfNeeded
 {
     VLCMediaParsedStatus parsedStatus = [self parsedStatus];
@@ -558,6 +585,8 @@ static const struct event_handler_entry {
 
 - (void)parsedChanged
 {
+    [self invalidateTracksCache];
+
     [self willChangeValueForKey:@"parsedStatus"];
     [self parsedStatus];
     [self didChangeValueForKey:@"parsedStatus"];
@@ -583,13 +612,13 @@ static const struct event_handler_entry {
     libvlc_media_t * p_md;
     p_md = libvlc_media_duplicate([media libVLCMediaDescriptor]);
 
-    for (NSString * key in [options allKeys]) {
-        if (options[key] != [NSNull null])
-            libvlc_media_add_option(p_md, [[NSString stringWithFormat:@"%@=%@", key, options[key]] UTF8String]);
-        else
-            libvlc_media_add_option(p_md, [[NSString stringWithFormat:@"%@", key] UTF8String]);
-    }
-    return [VLCMedia mediaWithLibVLCMediaDescriptor:p_md];
+    VLCMediaOptionTemplate *optionTemplate = [[VLCMediaOptionTemplate alloc] initWithOptions:options];
+    [optionTemplate applyToLibVLCMediaDescriptor:p_md];
+    VLCMedia *duplicate = [VLCMedia mediaWithLibVLCMediaDescriptor:p_md];
+    // the duplicated descriptor carries the options of the original as well
+    [duplicate recordLibVLCOptions:media.libVLCOptions];
+    [duplicate recordLibVLCOptions:optionTemplate.optionStrings];
+    return duplicate;
 }
 
 - (nullable instancetype)initWithLibVLCMediaDescriptor:(void *)md
@@ -609,6 +638,37 @@ static const struct event_handler_entry {
     return p_md;
 }
 
+- (void)invalidateTracksCache
+{
+    os_unfair_lock_lock(&_tracksCacheLock);
+    _tracksCacheGeneration++;
+    for (size_t i = 0; i < 3; i++)
+        _tracksCache[i] = nil;
+    _tracksInformationCache = nil;
+    os_unfair_lock_unlock(&_tracksCacheLock);
+}
+
+- (NSArray<NSString *> *)libVLCOptions
+{
+    os_unfair_lock_lock(&_optionsLock);
+    NSArray<NSString *> *options = _libVLCOptions ? [_libVLCOptions copy] : @[];
+    os_unfair_lock_unlock(&_optionsLock);
+    return options;
+}
+
+- (void)recordLibVLCOptions:(NSArray<NSString *> *)options
+{
+    if (options.count == 0)
+        return;
+
+    os_unfair_lock_lock(&_optionsLock);
+    if (!_libVLCOptions)
+        _libVLCOptions = [[NSMutableArray alloc] initWithArray:options];
+    else
+        [_libVLCOptions addObjectsFromArray:options];
+    os_unfair_lock_unlock(&_optionsLock);
+}
+
 
 @end
 
@@ -658,6 +718,25 @@ static const struct event_handler_entry {
 #pragma mark - Private
 
 - (NSArray<VLCMediaTrack *> *)_tracksForType:(const libvlc_track_type_t)type
+{
+    os_unfair_lock_lock(&_tracksCacheLock);
+    NSArray<VLCMediaTrack *> *tracks = _tracksCache[type];
+    const NSUInteger generation = _tracksCacheGeneration;
+    os_unfair_lock_unlock(&_tracksCacheLock);
+    if (tracks)
+        return tracks;
+
+    tracks = [self _fetchTracksForType: type];
+
+    // don't publish the result if the tracks changed while we were fetching them
+    os_unfair_lock_lock(&_tracksCacheLock);
+    if (generation == _tracksCacheGeneration && !_tracksCache[type])
+        _tracksCache[type] = tracks;
+    os_unfair_lock_unlock(&_tracksCacheLock);
+    return tracks;
+}
+
+- (NSArray<VLCMediaTrack *> *)_fetchTracksForType:(const libvlc_track_type_t)type
 {
     libvlc_media_tracklist_t *tracklist = libvlc_media_get_tracklist(p_md, type);
     if (!tracklist)
@@ -672,7 +751,7 @@ static const struct event_handler_entry {
             [tracks addObject: track];
     }
     libvlc_media_tracklist_delete(tracklist);
-    return tracks;
+    return [tracks copy];
 }
 
 @end
@@ -28,18 +28,56 @@
 #import <VLCMediaList.h>
 #import <VLCLibrary.h>
 #import <VLCLibVLCBridging.h>
+#import <VLCMediaList+Internal.h>
 #import <VLCEventsHandler.h>
+#import <VLCTime.h>
 #ifdef HAVE_CONFIG_H
 # include "config.h"
 #endif
 
 #include <vlc/vlc.h>
 #include <vlc/libvlc.h>
+#include <os/lock.h>
 
 /* Notification Messages */
 NSNotificationName const VLCMediaListItemAddedNotification = @"VLCMediaListItemAddedNotification";
 NSNotificationName const VLCMediaListItemDeletedNotification = @"VLCMediaListItemDeletedNotification";
 
+/* Binary list format written by writeToURL:error:, little-endian
+ *
+ * header: "VLCL", uint32 version, uint32 entry count, uint32 reserved
+ * entry:  int64 duration in ms or -1, uint16 option count, uint8 meta count,
+ *         uint8 reserved, the MRL, the options, then each meta as an uint8
+ *         libvlc_meta_t followed by its value
+ *
+ * Strings are an uint32 size including the NUL terminator followed by their
+ * bytes, so that libvlc reads them straight from the mapped file. */
+static const char kSerializedListMagic[4] = { 'V', 'L', 'C', 'L' };
+static const uint32_t kSerializedListVersion = 1;
+static const size_t kSerializedEntryMinimumSize = 8 + 2 + 1 + 1 + 4 + 1;
+static const libvlc_meta_t kSerializedMetaKeys[] = {
+    libvlc_meta_Title,
+    libvlc_meta_Artist,
+    libvlc_meta_Album,
+    libvlc_meta_AlbumArtist,
+    libvlc_meta_Genre,
+    libvlc_meta_TrackNumber,
+    libvlc_meta_Date,
+    libvlc_meta_ArtworkURL,
+};
+#define SERIALIZED_META_COUNT (sizeof(kSerializedMetaKeys) / sizeof(kSerializedMetaKeys[0]))
+
+/* Generation reached by the change being notified to KVO observers on this thread */
+static __thread NSUInteger sNotifiedMediaGeneration = NSNotFound;
+
+static void DidChangeMedia(VLCMediaList *mediaList, NSKeyValueChange change, NSIndexSet *indexes, NSUInteger generation)
+{
+    const NSUInteger previousGeneration = sNotifiedMediaGeneration;
+    sNotifiedMediaGeneration = generation;
+    [mediaList didChange: change valuesAtIndexes: indexes forKey: @"media"];
+    sNotifiedMediaGeneration = previousGeneration;
+}
+
 // TODO: Documentation
 @interface VLCMediaList (Private)
 
@@ -47,8 +85,38 @@ NSNotificationName const VLCMediaListItemDeletedNotification = @"VLCMediaListIte
 - (void)initInternalMediaList;
 
 /* Libvlc event bridges */
-- (VLCMedia *)mediaListItemAdded:(VLCMedia *)addedMedia atIndex:(const NSUInteger)index;
-- (void)mediaListItemRemoved:(VLCMedia *)removedMedia;
+- (BOOL)consumeExpectedAddition:(void *)md;
+- (BOOL)consumeExpectedDeletion:(void *)md;
+- (NSUInteger)mediaListItemAdded:(id)entry atIndex:(const NSUInteger)index;
+- (NSUInteger)mediaListItemRemoved:(void *)md atIndex:(const NSUInteger)index;
+- (VLCMedia *)mediaForLibVLCMediaDescriptor:(void *)md atIndex:(const NSUInteger)index;
+
+/* Creates the VLCMedia of a pending item, to be called without _mediaObjectsLock held */
+- (VLCMedia *)materializedMediaForEntry:(id)entry atIndex:(NSUInteger)index;
+
+/* Cache helpers, to be called with _mediaObjectsLock held */
+- (NSUInteger)cachedIndexOfMediaDescriptor:(void *)md;
+- (void)updateIndexMapWithMediaInRange:(NSRange)range;
+- (void)updateIndexMapAfterInsertionInRange:(NSRange)range;
+- (void)updateIndexMapAfterRemovalOfMedia:(NSArray *)removedMedia atIndexes:(NSIndexSet *)indexes;
+@end
+
+/**
+ * Stands in for a VLCMedia in lists created or filled by libvlc until the media
+ * is first accessed, so that wrapping a large list only retains the descriptors.
+ */
+@interface VLCMediaListPendingItem : NSObject
+{
+    libvlc_media_t *_md;
+}
+- (instancetype)initWithLibVLCMediaDescriptor:(libvlc_media_t *)md;
+- (void *)libVLCMediaDescriptor;
+/* Calls into libvlc and KVO, never with _mediaObjectsLock held */
+- (VLCMedia *)makeMedia;
+
+/* Restored from a saved list and handed over to the VLCMedia */
+@property (nonatomic, copy, nullable) NSArray<NSString *> *options;
+@property (nonatomic) int64_t duration;     ///< in ms, -1 if unknown
 @end
 
 /* libvlc event callback */
@@ -59,23 +127,27 @@ static void HandleMediaListItemAdded(const libvlc_event_t * event, void * opaque
         if (!item)
             return;
         
-        VLCMedia *addedMedia = [VLCMedia mediaWithLibVLCMediaDescriptor: item];
-        if (!addedMedia)
-            return;
+        // expanding a playlist adds thousands of items, their VLCMedia is only made on first access
+        VLCMediaListPendingItem *addedItem = [[VLCMediaListPendingItem alloc] initWithLibVLCMediaDescriptor: item];
         
         const NSUInteger index = (NSUInteger)event->u.media_list_item_added.index;
         VLCEventsHandler *eventsHandler = (__bridge VLCEventsHandler*)opaque;
         [eventsHandler handleEvent:^(id _Nonnull object) {
             VLCMediaList *mediaList = (VLCMediaList *)object;
-            NSIndexSet *indexSet = [NSIndexSet indexSetWithIndex: index];
-            [mediaList willChange: NSKeyValueChangeInsertion valuesAtIndexes: indexSet forKey: @"media"];
-            
-            VLCMedia *foundMedia = [mediaList mediaListItemAdded: addedMedia atIndex: index];
-            
-            [mediaList didChange: NSKeyValueChangeInsertion valuesAtIndexes: indexSet forKey: @"media"];
+            // items inserted through our own API are already cached and were reported to KVO observers
+            if (![mediaList consumeExpectedAddition: [addedItem libVLCMediaDescriptor]]) {
+                NSIndexSet *indexSet = [NSIndexSet indexSetWithIndex: index];
+                [mediaList willChange: NSKeyValueChangeInsertion valuesAtIndexes: indexSet forKey: @"media"];
+
+                const NSUInteger generation = [mediaList mediaListItemAdded: addedItem atIndex: index];
+
+                DidChangeMedia(mediaList, NSKeyValueChangeInsertion, indexSet, generation);
+            }
             
             if ([mediaList.delegate respondsToSelector: @selector(mediaList:mediaAdded:atIndex:)])
-                [mediaList.delegate mediaList: mediaList mediaAdded: foundMedia atIndex: index];
+                [mediaList.delegate mediaList: mediaList
+                                   mediaAdded: [mediaList mediaForLibVLCMediaDescriptor: [addedItem libVLCMediaDescriptor] atIndex: index]
+                                      atIndex: index];
             
             NSNotification *notification = [NSNotification notificationWithName: VLCMediaListItemAddedNotification
                                                                          object: mediaList
@@ -92,20 +164,21 @@ static void HandleMediaListItemDeleted( const libvlc_event_t * event, void * opa
         if (!item)
             return;
         
-        VLCMedia *removedMedia = [VLCMedia mediaWithLibVLCMediaDescriptor: item];
-        if (!removedMedia)
-            return;
+        // only keeps the descriptor alive, so that its address is not reused until we are done
+        VLCMediaListPendingItem *removedItem = [[VLCMediaListPendingItem alloc] initWithLibVLCMediaDescriptor: item];
         
         const NSUInteger index = (NSUInteger)event->u.media_list_item_deleted.index;
         VLCEventsHandler *eventsHandler = (__bridge VLCEventsHandler*)opaque;
         [eventsHandler handleEvent:^(id _Nonnull object) {
             VLCMediaList *mediaList = (VLCMediaList *)object;
-            NSIndexSet *indexSet = [NSIndexSet indexSetWithIndex: index];
-            [mediaList willChange: NSKeyValueChangeRemoval valuesAtIndexes: indexSet forKey: @"media"];
-            
-            [mediaList mediaListItemRemoved: removedMedia];
-            
-            [mediaList didChange: NSKeyValueChangeRemoval valuesAtIndexes: indexSet forKey: @"media"];
+            if (![mediaList consumeExpectedDeletion: [removedItem libVLCMediaDescriptor]]) {
+                NSIndexSet *indexSet = [NSIndexSet indexSetWithIndex: index];
+                [mediaList willChange: NSKeyValueChangeRemoval valuesAtIndexes: indexSet forKey: @"media"];
+
+                const NSUInteger generation = [mediaList mediaListItemRemoved: [removedItem libVLCMediaDescriptor] atIndex: index];
+
+                DidChangeMedia(mediaList, NSKeyValueChangeRemoval, indexSet, generation);
+            }
             
             if ([mediaList.delegate respondsToSelector:@selector(mediaList:mediaRemovedAtIndex:)])
                 [mediaList.delegate mediaList: mediaList mediaRemovedAtIndex: index];
@@ -118,13 +191,206 @@ static void HandleMediaListItemDeleted( const libvlc_event_t * event, void * opa
     }
 }
 
+@implementation VLCMediaListPendingItem
+
+- (instancetype)initWithLibVLCMediaDescriptor:(libvlc_media_t *)md
+{
+    if (self = [super init]) {
+        _md = md;
+        libvlc_media_retain(_md);
+        _duration = -1;
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    libvlc_media_release(_md);
+}
+
+- (void *)libVLCMediaDescriptor
+{
+    return _md;
+}
+
+- (VLCMedia *)makeMedia
+{
+    VLCMedia *media = [VLCMedia mediaWithLibVLCMediaDescriptor: _md];
+    if (_options)
+        [media recordLibVLCOptions: _options];
+    // libvlc only learns the duration by parsing, use the one saved with the list meanwhile
+    if (_duration >= 0 && libvlc_media_get_duration(_md) < 0)
+        media.length = [VLCTime timeWithNumber: @(_duration)];
+    return media;
+}
+
+@end
+
+/* Serialization helpers */
+
+typedef struct {
+    const uint8_t *bytes;
+    size_t length;
+    size_t offset;
+} vlc_list_reader_t;
+
+static BOOL ReadBytes(vlc_list_reader_t *reader, void *dest, size_t size)
+{
+    if (reader->length - reader->offset < size)
+        return NO;
+    memcpy(dest, reader->bytes + reader->offset, size);
+    reader->offset += size;
+    return YES;
+}
+
+/* Returns a pointer into the mapped data, NULL if the string is truncated */
+static const char *ReadString(vlc_list_reader_t *reader)
+{
+    uint32_t size;
+    if (!ReadBytes(reader, &size, sizeof(size)))
+        return NULL;
+    size = CFSwapInt32LittleToHost(size);
+    if (size == 0 || reader->length - reader->offset < size)
+        return NULL;
+
+    const char *string = (const char *)reader->bytes + reader->offset;
+    if (string[size - 1] != '\0')
+        return NULL;
+    reader->offset += size;
+    return string;
+}
+
+static void AppendString(NSMutableData *data, const char *string)
+{
+    const size_t length = strlen(string) + 1;
+    const uint32_t size = CFSwapInt32HostToLittle((uint32_t)length);
+    [data appendBytes:&size length:sizeof(size)];
+    [data appendBytes:string length:length];
+}
+
+static void AppendEntry(NSMutableData *data, libvlc_media_t *md, NSArray<NSString *> *options, int64_t duration)
+{
+    char *metaValues[SERIALIZED_META_COUNT];
+    uint8_t metaCount = 0;
+    for (size_t i = 0; i < SERIALIZED_META_COUNT; i++) {
+        metaValues[i] = libvlc_media_get_meta(md, kSerializedMetaKeys[i]);
+        if (metaValues[i] && metaValues[i][0] != '\0')
+            metaCount++;
+    }
+
+    const uint16_t optionCount = (uint16_t)MIN(options.count, UINT16_MAX);
+    const uint64_t durationLE = CFSwapInt64HostToLittle((uint64_t)(duration < 0 ? -1 : duration));
+    const uint16_t optionCountLE = CFSwapInt16HostToLittle(optionCount);
+    const uint8_t counts[2] = { metaCount, 0 };
+    [data appendBytes:&durationLE length:sizeof(durationLE)];
+    [data appendBytes:&optionCountLE length:sizeof(optionCountLE)];
+    [data appendBytes:counts length:sizeof(counts)];
+
+    char *mrl = libvlc_media_get_mrl(md);
+    AppendString(data, mrl ? mrl : "");
+    free(mrl);
+
+    for (uint16_t i = 0; i < optionCount; i++)
+        AppendString(data, options[i].UTF8String ?: "");
+
+    for (size_t i = 0; i < SERIALIZED_META_COUNT; i++) {
+        if (metaValues[i] && metaValues[i][0] != '\0') {
+            const uint8_t key = (uint8_t)kSerializedMetaKeys[i];
+            [data appendBytes:&key length:sizeof(key)];
+            AppendString(data, metaValues[i]);
+        }
+        free(metaValues[i]);
+    }
+}
+
+/* Returns nil if the data is not a valid list. Entries whose MRL libvlc
+ * rejects are skipped. */
+static NSMutableArray<VLCMediaListPendingItem *> *ReadSerializedList(NSData *data)
+{
+    vlc_list_reader_t reader = { data.bytes, data.length, 0 };
+    char magic[sizeof(kSerializedListMagic)];
+    uint32_t header[3];
+    if (!ReadBytes(&reader, magic, sizeof(magic)) || memcmp(magic, kSerializedListMagic, sizeof(magic)) != 0)
+        return nil;
+    if (!ReadBytes(&reader, header, sizeof(header)) || CFSwapInt32LittleToHost(header[0]) != kSerializedListVersion)
+        return nil;
+
+    const uint32_t count = CFSwapInt32LittleToHost(header[1]);
+    // do not trust the count of a truncated file for the allocation
+    NSMutableArray<VLCMediaListPendingItem *> *entries = [NSMutableArray arrayWithCapacity:MIN(count, data.length / kSerializedEntryMinimumSize)];
+    for (uint32_t i = 0; i < count; i++) {
+        uint64_t duration;
+        uint16_t optionCount;
+        uint8_t counts[2];
+        if (!ReadBytes(&reader, &duration, sizeof(duration))
+            || !ReadBytes(&reader, &optionCount, sizeof(optionCount))
+            || !ReadBytes(&reader, counts, sizeof(counts)))
+            return nil;
+        optionCount = CFSwapInt16LittleToHost(optionCount);
+
+        const char *mrl = ReadString(&reader);
+        if (!mrl)
+            return nil;
+        libvlc_media_t *md = libvlc_media_new_location(mrl);
+
+        NSMutableArray<NSString *> *options = optionCount > 0 ? [NSMutableArray arrayWithCapacity:optionCount] : nil;
+        for (uint16_t j = 0; j < optionCount; j++) {
+            const char *option = ReadString(&reader);
+            if (!option) {
+                if (md)
+                    libvlc_media_release(md);
+                return nil;
+            }
+            if (!md)
+                continue;
+            libvlc_media_add_option(md, option);
+            NSString *optionString = [NSString stringWithUTF8String:option];
+            if (optionString)
+                [options addObject:optionString];
+        }
+
+        for (uint8_t j = 0; j < counts[0]; j++) {
+            uint8_t key;
+            const char *value = ReadBytes(&reader, &key, sizeof(key)) ? ReadString(&reader) : NULL;
+            if (!value) {
+                if (md)
+                    libvlc_media_release(md);
+                return nil;
+            }
+            if (md && key <= libvlc_meta_DiscTotal)
+                libvlc_media_set_meta(md, (libvlc_meta_t)key, value);
+        }
+
+        if (!md)
+            continue;
+        VLCMediaListPendingItem *item = [[VLCMediaListPendingItem alloc] initWithLibVLCMediaDescriptor:md];
+        libvlc_media_release(md);
+        item.options = options;
+        item.duration = (int64_t)CFSwapInt64LittleToHost(duration);
+        [entries addObject:item];
+    }
+    return entries;
+}
+
 @interface VLCMediaList()
 {
     void * p_mlist;                                 ///< Internal instance of media list
     /* We need that private copy because of Cocoa Bindings, that need to be working on first thread */
-    NSMutableArray<VLCMedia *> *_mediaObjects;                   ///< Private copy of media objects.
-    dispatch_queue_t _serialMediaObjectsQueue;      ///< Queue for accessing and modifying the mediaobjects
+    NSMutableArray *_mediaObjects;                  ///< Private copy of media objects, VLCMedia or VLCMediaListPendingItem
+    /* Immutable copy of _mediaObjects handed to readers, dropped by every mutation
+     * and made again on demand, so that a burst of writes costs a single copy. */
+    NSArray<VLCMedia *> *_mediaSnapshot;
+    NSUInteger _mediaObjectsGeneration;             ///< Bumped with every mutation of _mediaObjects, not by materialization
+    os_unfair_lock _mediaObjectsLock;               ///< Protects the ivars below, never held across libvlc or KVO calls
     VLCEventsHandler*       _eventsHandler;          /// handles libvlc event callbacks
+    /* libvlc events caused by our own mutations, keyed by libvlc_media_t */
+    NSCountedSet<NSValue *> *_expectedAdditions;
+    NSCountedSet<NSValue *> *_expectedDeletions;
+    /* libvlc_media_t to the lowest index holding it.
+     * Appends and trailing removals keep it up to date, anything else marks it stale
+     * and it is rebuilt on the next lookup. */
+    CFMutableDictionaryRef _indexMap;
+    BOOL _indexMapValid;
 }
 @end
 
@@ -137,12 +403,12 @@ static void HandleMediaListItemDeleted( const libvlc_event_t * event, void * opa
 
         // Initialize internals to defaults
         _mediaObjects = [[NSMutableArray alloc] init];
+        _expectedAdditions = [[NSCountedSet alloc] init];
+        _expectedDeletions = [[NSCountedSet alloc] init];
+        _indexMap = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, NULL, NULL);
+        _indexMapValid = YES;
+        _mediaObjectsLock = OS_UNFAIR_LOCK_INIT;
 
-        dispatch_queue_attr_t qosAttribute = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL,
-                                                                                     QOS_CLASS_USER_INITIATED,
-                                                                                     0);
-
-        _serialMediaObjectsQueue = dispatch_queue_create("org.videolan.serialMediaObjectsQueue", qosAttribute);
         [self initInternalMediaList];
     }
 
@@ -152,15 +418,50 @@ static void HandleMediaListItemDeleted( const libvlc_event_t * event, void * opa
 - (instancetype)initWithArray:(nullable NSArray<VLCMedia *> *)array
 {
     if (self = [self init]) {
-        /* do something useful with the provided array */
-        [array enumerateObjectsUsingBlock:^(VLCMedia * _Nonnull media, NSUInteger idx, BOOL * _Nonnull stop) {
-            [self addMedia: media];
-        }];
+        if (array)
+            [self addMediaFromArray: array];
     }
 
     return self;
 }
 
+- (nullable instancetype)initWithContentsOfURL:(NSURL *)url error:(NSError **)error
+{
+    NSData *data = [NSData dataWithContentsOfURL:url options:NSDataReadingMappedAlways error:error];
+    if (!data)
+        return nil;
+
+    NSMutableArray<VLCMediaListPendingItem *> *entries = ReadSerializedList(data);
+    if (!entries) {
+        if (error)
+            *error = [NSError errorWithDomain:NSCocoaErrorDomain
+                                         code:NSFileReadCorruptFileError
+                                     userInfo:@{NSURLErrorKey: url}];
+        return nil;
+    }
+
+    if (self = [super init]) {
+        p_mlist = libvlc_media_list_new();
+        // not published yet, no need to lock. The VLCMedia are created on first access.
+        _mediaObjects = entries;
+        _expectedAdditions = [[NSCountedSet alloc] init];
+        _expectedDeletions = [[NSCountedSet alloc] init];
+        _indexMap = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, NULL, NULL);
+        _indexMapValid = NO; // built on the first lookup
+        _mediaObjectsLock = OS_UNFAIR_LOCK_INIT;
+
+        // events are attached afterwards, so filling the libvlc list does not report anything
+        libvlc_media_list_lock(p_mlist);
+        const NSUInteger count = entries.count;
+        for (NSUInteger i = 0; i < count; i++)
+            libvlc_media_list_insert_media(p_mlist, [entries[i] libVLCMediaDescriptor], (int)i);
+        libvlc_media_list_unlock(p_mlist);
+
+        [self initInternalMediaList];
+    }
+    return self;
+}
+
 - (void)dealloc
 {
     libvlc_event_manager_t *em = libvlc_media_list_event_manager(p_mlist);
@@ -173,17 +474,58 @@ static void HandleMediaListItemDeleted( const libvlc_event_t * event, void * opa
     _delegate = nil;
 
     libvlc_media_list_release( p_mlist );
+
+    if (_indexMap)
+        CFRelease(_indexMap);
 }
 
 - (NSString *)description
 {
     NSMutableString * content = [NSMutableString string];
-    for (NSInteger i = 0; i < [self count]; i++) {
-        [content appendFormat:@"%@\n", [self mediaAtIndex: i]];
+    for (VLCMedia *media in self.media) {
+        [content appendFormat:@"%@\n", media];
     }
     return [NSString stringWithFormat:@"<%@ %p> {\n%@}", [self class], self, content];
 }
 
+- (BOOL)writeToURL:(NSURL *)url error:(NSError **)error
+{
+    os_unfair_lock_lock(&_mediaObjectsLock);
+    NSArray *entries = [_mediaObjects copy];
+    os_unfair_lock_unlock(&_mediaObjectsLock);
+
+    NSMutableData *data = [NSMutableData dataWithCapacity:sizeof(kSerializedListMagic) + 3 * sizeof(uint32_t) + entries.count * 128];
+    const uint32_t header[3] = {
+        CFSwapInt32HostToLittle(kSerializedListVersion),
+        CFSwapInt32HostToLittle((uint32_t)entries.count),
+        0
+    };
+    [data appendBytes:kSerializedListMagic length:sizeof(kSerializedListMagic)];
+    [data appendBytes:header length:sizeof(header)];
+
+    for (id entry in entries) {
+        libvlc_media_t *md = [entry libVLCMediaDescriptor];
+        int64_t duration = libvlc_media_get_duration(md);
+        NSArray<NSString *> *options;
+        if ([entry isKindOfClass:[VLCMediaListPendingItem class]]) {
+            VLCMediaListPendingItem *pendingItem = entry;
+            options = pendingItem.options;
+            if (duration < 0)
+                duration = pendingItem.duration;
+        } else {
+            VLCMedia *media = entry;
+            options = media.libVLCOptions;
+            // restored from a saved list and not parsed since
+            NSNumber *length = media.length.value;
+            if (duration < 0 && length)
+                duration = length.longLongValue;
+        }
+        AppendEntry(data, md, options, duration);
+    }
+
+    return [data writeToURL:url options:NSDataWritingAtomic error:error];
+}
+
 - (void)lock
 {
     libvlc_media_list_lock( p_mlist );
@@ -196,52 +538,223 @@ static void HandleMediaListItemDeleted( const libvlc_event_t * event, void * opa
 
 - (NSUInteger)addMedia:(VLCMedia *)media
 {
-    NSInteger index = [self count];
-    [self insertMedia:media atIndex:index];
-    return index;
+    return [self insertMediaArray:@[media] atIndex:NSNotFound].location;
 }
 
 - (void)insertMedia:(VLCMedia *)media atIndex: (NSUInteger)index
 {
-    // Add the media object to our cache
-    dispatch_sync(_serialMediaObjectsQueue, ^{
-        [_mediaObjects insertObject:media atIndex:index];
-    });
+    [self insertMediaArray:@[media] atIndex:index];
+}
 
-    // Add it to libvlc's medialist
-    libvlc_media_list_insert_media(p_mlist, [media libVLCMediaDescriptor], (int)index);
+- (NSRange)addMediaFromArray:(NSArray<VLCMedia *> *)mediaArray
+{
+    return [self insertMediaArray:mediaArray atIndex:NSNotFound];
 }
 
 - (BOOL)removeMediaAtIndex:(NSUInteger)index
 {
-    __block BOOL ok = YES;
+    return [self removeMediaAtIndexes:[NSIndexSet indexSetWithIndex:index]];
+}
 
-    dispatch_sync(_serialMediaObjectsQueue, ^{
-        // Remove from cached Media
-        if (index >= [_mediaObjects count]) {
-            ok = NO;
-            return;
-        }
-        [_mediaObjects removeObjectAtIndex:index];
-    });
+/* Bulk mutations
+ *
+ * Each of them updates our cache in one step, emits a single KVO change and
+ * takes the libvlc list lock once. The libvlc events they cause are recorded
+ * as expected so that the event handlers do not apply them a second time.
+ *
+ * The libvlc list lock is held from the bounds check to the end, so that two
+ * mutations cannot interleave. Our cache lock is dropped around willChange,
+ * observers may read the list from there. */
+
+- (NSRange)insertMediaArray:(NSArray<VLCMedia *> *)mediaArray atIndex:(NSUInteger)index
+{
+    libvlc_media_list_lock(p_mlist);
+    os_unfair_lock_lock(&_mediaObjectsLock);
+    const NSUInteger count = _mediaObjects.count;
+    os_unfair_lock_unlock(&_mediaObjectsLock);
+    if (index == NSNotFound || index > count)
+        index = count;
+
+    if (mediaArray.count == 0 || [self isReadOnly]) {
+        libvlc_media_list_unlock(p_mlist);
+        return NSMakeRange(index, 0);
+    }
 
-    // Remove from libvlc's medialist
-    libvlc_media_list_remove_index(p_mlist, (int)index);
-    return ok;
+    const NSRange range = NSMakeRange(index, mediaArray.count);
+    NSIndexSet *indexSet = [NSIndexSet indexSetWithIndexesInRange:range];
+    [self willChange:NSKeyValueChangeInsertion valuesAtIndexes:indexSet forKey:@"media"];
+
+    os_unfair_lock_lock(&_mediaObjectsLock);
+    [_mediaObjects insertObjects:mediaArray atIndexes:indexSet];
+    _mediaSnapshot = nil;
+    _mediaObjectsGeneration++;
+    [self updateIndexMapAfterInsertionInRange:range];
+    for (VLCMedia *media in mediaArray)
+        [_expectedAdditions addObject:[NSValue valueWithPointer:[media libVLCMediaDescriptor]]];
+    const NSUInteger generation = _mediaObjectsGeneration;
+    os_unfair_lock_unlock(&_mediaObjectsLock);
+    const int libvlcCount = libvlc_media_list_count(p_mlist);
+    const int libvlcIndex = MIN((int)index, libvlcCount);
+    for (NSUInteger i = 0; i < mediaArray.count; i++)
+        libvlc_media_list_insert_media(p_mlist, [mediaArray[i] libVLCMediaDescriptor], libvlcIndex + (int)i);
+    libvlc_media_list_unlock(p_mlist);
+
+    DidChangeMedia(self, NSKeyValueChangeInsertion, indexSet, generation);
+    return range;
+}
+
+- (BOOL)removeMediaAtIndexes:(NSIndexSet *)indexes
+{
+    libvlc_media_list_lock(p_mlist);
+    os_unfair_lock_lock(&_mediaObjectsLock);
+    const NSUInteger count = _mediaObjects.count;
+    os_unfair_lock_unlock(&_mediaObjectsLock);
+    const BOOL valid = indexes.count > 0 && indexes.lastIndex < count;
+    if (!valid || [self isReadOnly]) {
+        libvlc_media_list_unlock(p_mlist);
+        return valid;
+    }
+
+    [self willChange:NSKeyValueChangeRemoval valuesAtIndexes:indexes forKey:@"media"];
+
+    os_unfair_lock_lock(&_mediaObjectsLock);
+    // keeps the removed media alive until the lock is released
+    NSArray *removedMedia = [_mediaObjects objectsAtIndexes:indexes];
+    for (id media in removedMedia)
+        [_expectedDeletions addObject:[NSValue valueWithPointer:[media libVLCMediaDescriptor]]];
+    [_mediaObjects removeObjectsAtIndexes:indexes];
+    _mediaSnapshot = nil;
+    _mediaObjectsGeneration++;
+    [self updateIndexMapAfterRemovalOfMedia:removedMedia atIndexes:indexes];
+    const NSUInteger generation = _mediaObjectsGeneration;
+    os_unfair_lock_unlock(&_mediaObjectsLock);
+    // back to front so that the remaining indexes stay valid
+    [indexes enumerateIndexesWithOptions:NSEnumerationReverse usingBlock:^(NSUInteger idx, BOOL *stop) {
+        libvlc_media_list_remove_index(p_mlist, (int)idx);
+    }];
+    libvlc_media_list_unlock(p_mlist);
+
+    DidChangeMedia(self, NSKeyValueChangeRemoval, indexes, generation);
+    return YES;
+}
+
+- (BOOL)moveMediaAtIndexes:(NSIndexSet *)indexes toIndex:(NSUInteger)index
+{
+    libvlc_media_list_lock(p_mlist);
+    os_unfair_lock_lock(&_mediaObjectsLock);
+    const NSUInteger count = _mediaObjects.count;
+    os_unfair_lock_unlock(&_mediaObjectsLock);
+    const BOOL valid = indexes.count > 0 && indexes.lastIndex < count && index <= count - indexes.count;
+    if (!valid || [self isReadOnly]) {
+        libvlc_media_list_unlock(p_mlist);
+        return valid;
+    }
+
+    // libvlc has no move, report the whole span touched by the move as replaced
+    const NSUInteger first = MIN(indexes.firstIndex, index);
+    const NSUInteger last = MAX(indexes.lastIndex, index + indexes.count - 1);
+    NSIndexSet *affected = [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(first, last - first + 1)];
+    NSIndexSet *destination = [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(index, indexes.count)];
+    [self willChange:NSKeyValueChangeReplacement valuesAtIndexes:affected forKey:@"media"];
+
+    os_unfair_lock_lock(&_mediaObjectsLock);
+    NSArray *movedMedia = [_mediaObjects objectsAtIndexes:indexes];
+    [_mediaObjects removeObjectsAtIndexes:indexes];
+    [_mediaObjects insertObjects:movedMedia atIndexes:destination];
+    _mediaSnapshot = nil;
+    _mediaObjectsGeneration++;
+    _indexMapValid = NO;
+    for (id media in movedMedia) {
+        NSValue *key = [NSValue valueWithPointer:[media libVLCMediaDescriptor]];
+        [_expectedDeletions addObject:key];
+        [_expectedAdditions addObject:key];
+    }
+    const NSUInteger generation = _mediaObjectsGeneration;
+    os_unfair_lock_unlock(&_mediaObjectsLock);
+    [indexes enumerateIndexesWithOptions:NSEnumerationReverse usingBlock:^(NSUInteger idx, BOOL *stop) {
+        libvlc_media_list_remove_index(p_mlist, (int)idx);
+    }];
+    for (NSUInteger i = 0; i < movedMedia.count; i++)
+        libvlc_media_list_insert_media(p_mlist, [movedMedia[i] libVLCMediaDescriptor], (int)(index + i));
+    libvlc_media_list_unlock(p_mlist);
+
+    DidChangeMedia(self, NSKeyValueChangeReplacement, affected, generation);
+    return YES;
 }
 
 - (nullable VLCMedia *)mediaAtIndex:(NSUInteger)index
 {
-    __block VLCMedia *media;
-    dispatch_sync(_serialMediaObjectsQueue, ^{
-        media = index >= [_mediaObjects count] ? nil : [_mediaObjects objectAtIndex:index];
-    });
-    return media;
+    os_unfair_lock_lock(&_mediaObjectsLock);
+    id entry = index < _mediaObjects.count ? _mediaObjects[index] : nil;
+    os_unfair_lock_unlock(&_mediaObjectsLock);
+    return entry ? [self materializedMediaForEntry:entry atIndex:index] : nil;
+}
+
+- (NSArray<VLCMedia *> *)media
+{
+    return [self mediaWithGeneration:NULL];
+}
+
+- (NSArray<VLCMedia *> *)mediaWithGeneration:(nullable NSUInteger *)snapshotGeneration
+{
+    for (;;) {
+        os_unfair_lock_lock(&_mediaObjectsLock);
+        NSArray<VLCMedia *> *snapshot = _mediaSnapshot;
+        NSArray *entries = snapshot ? nil : [_mediaObjects copy];
+        const NSUInteger generation = _mediaObjectsGeneration;
+        os_unfair_lock_unlock(&_mediaObjectsLock);
+        if (snapshot) {
+            if (snapshotGeneration)
+                *snapshotGeneration = generation;
+            return snapshot;
+        }
+
+        // wrappers are made outside of the lock, then published along with the snapshot
+        BOOL materialized = YES;
+        const NSUInteger count = entries.count;
+        for (NSUInteger i = 0; i < count; i++) {
+            if ([entries[i] isKindOfClass:[VLCMediaListPendingItem class]]) {
+                [self materializedMediaForEntry:entries[i] atIndex:i];
+                materialized = NO;
+            }
+        }
+
+        os_unfair_lock_lock(&_mediaObjectsLock);
+        if (materialized && !_mediaSnapshot && generation == _mediaObjectsGeneration)
+            _mediaSnapshot = entries;
+        os_unfair_lock_unlock(&_mediaObjectsLock);
+        // otherwise start over with the entries just materialized, or with the list as changed meanwhile
+    }
+}
+
+- (NSUInteger)mediaGeneration
+{
+    os_unfair_lock_lock(&_mediaObjectsLock);
+    const NSUInteger generation = _mediaObjectsGeneration;
+    os_unfair_lock_unlock(&_mediaObjectsLock);
+    return generation;
+}
+
++ (NSUInteger)notifiedMediaGeneration
+{
+    return sNotifiedMediaGeneration;
+}
+
+- (NSUInteger)mediaCountWithGeneration:(NSUInteger *)generation
+{
+    os_unfair_lock_lock(&_mediaObjectsLock);
+    const NSUInteger count = _mediaObjects.count;
+    *generation = _mediaObjectsGeneration;
+    os_unfair_lock_unlock(&_mediaObjectsLock);
+    return count;
 }
 
 - (NSUInteger)indexOfMedia:(VLCMedia *)media
 {
-    return [_mediaObjects indexOfObject:media];
+    os_unfair_lock_lock(&_mediaObjectsLock);
+    const NSUInteger index = [self cachedIndexOfMediaDescriptor:[media libVLCMediaDescriptor]];
+    os_unfair_lock_unlock(&_mediaObjectsLock);
+    return index;
 }
 
 /* KVC Compliance: For the @"media" key */
@@ -257,10 +770,9 @@ static void HandleMediaListItemDeleted( const libvlc_event_t * event, void * opa
 
 - (NSInteger)count
 {
-    __block NSInteger count;
-    dispatch_sync(_serialMediaObjectsQueue, ^{
-        count = [_mediaObjects count];
-    });
+    os_unfair_lock_lock(&_mediaObjectsLock);
+    const NSInteger count = [_mediaObjects count];
+    os_unfair_lock_unlock(&_mediaObjectsLock);
     return count;
 }
 
@@ -294,13 +806,16 @@ static void HandleMediaListItemDeleted( const libvlc_event_t * event, void * opa
         libvlc_media_list_retain( p_mlist );
         libvlc_media_list_lock( p_mlist );
         _mediaObjects = [[NSMutableArray alloc] initWithCapacity:libvlc_media_list_count(p_mlist)];
-        _serialMediaObjectsQueue = dispatch_queue_create("org.videolan.serialMediaObjectsQueue", NULL);
+        _expectedAdditions = [[NSCountedSet alloc] init];
+        _expectedDeletions = [[NSCountedSet alloc] init];
+        _indexMap = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, NULL, NULL);
+        _indexMapValid = NO; // built on the first lookup
+        _mediaObjectsLock = OS_UNFAIR_LOCK_INIT;
         NSUInteger count = libvlc_media_list_count(p_mlist);
         for (int i = 0; i < count; i++) {
             libvlc_media_t * p_md = libvlc_media_list_item_at_index(p_mlist, i);
-            dispatch_sync(_serialMediaObjectsQueue, ^{
-                [_mediaObjects addObject:[VLCMedia mediaWithLibVLCMediaDescriptor:p_md]];
-            });
+            // not published yet, no need to lock. The VLCMedia is created on first access.
+            [_mediaObjects addObject:[[VLCMediaListPendingItem alloc] initWithLibVLCMediaDescriptor:p_md]];
             libvlc_media_release(p_md);
         }
         [self initInternalMediaList];
@@ -324,38 +839,163 @@ static void HandleMediaListItemDeleted( const libvlc_event_t * event, void * opa
         return;
     
     _eventsHandler = [VLCEventsHandler handlerWithObject:self configuration:[VLCLibrary sharedEventsConfiguration]];
-    /* We need the caller to wait until this block is done.
-     * The initialized object shall not be returned until the event attachments are done. */
-    dispatch_sync(_serialMediaObjectsQueue,^{
-        libvlc_event_attach( em, libvlc_MediaListItemAdded,   HandleMediaListItemAdded,   (__bridge void *)(_eventsHandler));
-        libvlc_event_attach( em, libvlc_MediaListItemDeleted, HandleMediaListItemDeleted, (__bridge void *)(_eventsHandler));
-    });
-}
-
-- (VLCMedia *)mediaListItemAdded:(VLCMedia *)addedMedia atIndex:(const NSUInteger)index
-{
-    __block VLCMedia *foundMedia;
-    dispatch_sync(_serialMediaObjectsQueue, ^{
-        // we have two instances of VLCMedia. One from the event and the one we added to _mediaObjects, hence check them to avoid duplication
-        const NSUInteger result = [_mediaObjects indexOfObject: addedMedia];
-        if (result != NSNotFound)
-            foundMedia = _mediaObjects[result];
-        
-        if (!foundMedia) {
-            // In case we found Media on the network we don't have a cached copy yet
-            foundMedia = addedMedia;
-            
-            index >= _mediaObjects.count ? [_mediaObjects addObject: foundMedia] : [_mediaObjects insertObject: foundMedia atIndex: index];
-        }
-    });
-    return foundMedia;
+    libvlc_event_attach( em, libvlc_MediaListItemAdded,   HandleMediaListItemAdded,   (__bridge void *)(_eventsHandler));
+    libvlc_event_attach( em, libvlc_MediaListItemDeleted, HandleMediaListItemDeleted, (__bridge void *)(_eventsHandler));
+}
+
+- (BOOL)consumeExpectedAddition:(void *)md
+{
+    NSValue *key = [NSValue valueWithPointer: md];
+    os_unfair_lock_lock(&_mediaObjectsLock);
+    const BOOL expected = [_expectedAdditions countForObject: key] > 0;
+    if (expected)
+        [_expectedAdditions removeObject: key];
+    os_unfair_lock_unlock(&_mediaObjectsLock);
+    return expected;
+}
+
+- (BOOL)consumeExpectedDeletion:(void *)md
+{
+    NSValue *key = [NSValue valueWithPointer: md];
+    os_unfair_lock_lock(&_mediaObjectsLock);
+    const BOOL expected = [_expectedDeletions countForObject: key] > 0;
+    if (expected)
+        [_expectedDeletions removeObject: key];
+    os_unfair_lock_unlock(&_mediaObjectsLock);
+    return expected;
+}
+
+- (NSUInteger)mediaListItemAdded:(id)entry atIndex:(const NSUInteger)index
+{
+    os_unfair_lock_lock(&_mediaObjectsLock);
+    const NSUInteger insertionIndex = MIN(index, _mediaObjects.count);
+    [_mediaObjects insertObject: entry atIndex: insertionIndex];
+    _mediaSnapshot = nil;
+    _mediaObjectsGeneration++;
+    [self updateIndexMapAfterInsertionInRange: NSMakeRange(insertionIndex, 1)];
+    const NSUInteger generation = _mediaObjectsGeneration;
+    os_unfair_lock_unlock(&_mediaObjectsLock);
+    return generation;
+}
+
+- (NSUInteger)mediaListItemRemoved:(void *)md atIndex:(const NSUInteger)index
+{
+    NSArray *removed = nil;
+    os_unfair_lock_lock(&_mediaObjectsLock);
+    NSUInteger result = index;
+    if (result >= _mediaObjects.count || [_mediaObjects[result] libVLCMediaDescriptor] != md)
+        result = [self cachedIndexOfMediaDescriptor: md];
+    if (result != NSNotFound) {
+        // keeps the removed media alive until the lock is released
+        removed = @[_mediaObjects[result]];
+        [_mediaObjects removeObjectAtIndex: result];
+        _mediaSnapshot = nil;
+        _mediaObjectsGeneration++;
+        [self updateIndexMapAfterRemovalOfMedia: removed atIndexes: [NSIndexSet indexSetWithIndex: result]];
+    }
+    // unchanged if the media was not cached
+    const NSUInteger generation = _mediaObjectsGeneration;
+    os_unfair_lock_unlock(&_mediaObjectsLock);
+    return generation;
+}
+
+/* Reports the media of an item added by libvlc, the wrapper made on first access is shared with the list */
+- (VLCMedia *)mediaForLibVLCMediaDescriptor:(void *)md atIndex:(const NSUInteger)index
+{
+    os_unfair_lock_lock(&_mediaObjectsLock);
+    NSUInteger result = index;
+    if (result >= _mediaObjects.count || [_mediaObjects[result] libVLCMediaDescriptor] != md)
+        result = [self cachedIndexOfMediaDescriptor: md];
+    id entry = result != NSNotFound ? _mediaObjects[result] : nil;
+    os_unfair_lock_unlock(&_mediaObjectsLock);
+    if (!entry)
+        return [VLCMedia mediaWithLibVLCMediaDescriptor: md];
+    return [self materializedMediaForEntry: entry atIndex: result];
+}
+
+/* Must be called without _mediaObjectsLock held, index is where the entry was last seen */
+- (VLCMedia *)materializedMediaForEntry:(id)entry atIndex:(NSUInteger)index
+{
+    if (![entry isKindOfClass: [VLCMediaListPendingItem class]])
+        return entry;
+
+    VLCMedia *media = [(VLCMediaListPendingItem *)entry makeMedia];
+
+    // the list may have changed meanwhile, and another reader may have published its own wrapper
+    os_unfair_lock_lock(&_mediaObjectsLock);
+    const NSUInteger count = _mediaObjects.count;
+    NSUInteger current = index < count && _mediaObjects[index] == entry ? index : [_mediaObjects indexOfObjectIdenticalTo: entry];
+    if (current != NSNotFound) {
+        // the pending item is still retained by the caller, it is not released under the lock
+        _mediaObjects[current] = media;
+    } else if (index < count) {
+        id published = _mediaObjects[index];
+        if ([published isKindOfClass: [VLCMedia class]] && [published libVLCMediaDescriptor] == [entry libVLCMediaDescriptor])
+            media = published;
+    }
+    os_unfair_lock_unlock(&_mediaObjectsLock);
+    return media;
+}
+
+/* Index map, all of these must be called with _mediaObjectsLock held */
+
+- (NSUInteger)cachedIndexOfMediaDescriptor:(void *)md
+{
+    if (!md)
+        return NSNotFound;
+
+    if (!_indexMapValid) {
+        CFDictionaryRemoveAllValues(_indexMap);
+        [self updateIndexMapWithMediaInRange: NSMakeRange(0, _mediaObjects.count)];
+        _indexMapValid = YES;
+    }
+
+    const void *value;
+    if (!CFDictionaryGetValueIfPresent(_indexMap, md, &value))
+        return NSNotFound;
+    return (NSUInteger)(uintptr_t)value;
+}
+
+- (void)updateIndexMapWithMediaInRange:(NSRange)range
+{
+    for (NSUInteger i = range.location; i < NSMaxRange(range); i++) {
+        void *md = [_mediaObjects[i] libVLCMediaDescriptor];
+        // keep the lowest index of duplicates
+        if (!CFDictionaryContainsKey(_indexMap, md))
+            CFDictionarySetValue(_indexMap, md, (const void *)(uintptr_t)i);
+    }
 }
 
-- (void)mediaListItemRemoved:(VLCMedia *)removedMedia
+- (void)updateIndexMapAfterInsertionInRange:(NSRange)range
 {
-    dispatch_sync(_serialMediaObjectsQueue, ^{
-        [_mediaObjects removeObject: removedMedia];
-    });
+    if (!_indexMapValid)
+        return;
+
+    // appending does not shift anything, which is the common case for event driven lists
+    if (NSMaxRange(range) == _mediaObjects.count)
+        [self updateIndexMapWithMediaInRange: range];
+    else
+        _indexMapValid = NO;
+}
+
+- (void)updateIndexMapAfterRemovalOfMedia:(NSArray *)removedMedia atIndexes:(NSIndexSet *)indexes
+{
+    if (!_indexMapValid)
+        return;
+
+    // removing the tail does not shift anything, and every duplicate of a removed item
+    // is either before it, keeping its index, or also part of the removed tail
+    if (indexes.firstIndex == _mediaObjects.count && indexes.count == indexes.lastIndex - indexes.firstIndex + 1) {
+        __block NSUInteger i = 0;
+        [indexes enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL *stop) {
+            void *md = [removedMedia[i++] libVLCMediaDescriptor];
+            const void *value;
+            if (CFDictionaryGetValueIfPresent(_indexMap, md, &value) && (NSUInteger)(uintptr_t)value == idx)
+                CFDictionaryRemoveValue(_indexMap, md);
+        }];
+    } else {
+        _indexMapValid = NO;
+    }
 }
 
 @end
@@ -0,0 +1,356 @@
+/*****************************************************************************
+ * VLCMediaListView.m: VLCKit.framework VLCMediaListView implementation
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#import <VLCMediaListView.h>
+#import <VLCMediaList.h>
+#import <VLCMediaList+Internal.h>
+#import <VLCMedia.h>
+
+#include <os/lock.h>
+
+static void *VLCMediaListViewContext = &VLCMediaListViewContext;
+
+/// larger batches are sorted once and merged instead of inserted one by one
+static const NSUInteger kBinaryInsertionLimit = 16;
+
+@implementation VLCMediaListView
+{
+    os_unfair_lock _lock;               ///< Protects everything below, never held while calling the change handler or the list
+    NSUInteger _generation;             ///< Generation of the list the mirror reflects
+    NSMutableArray<VLCMedia *> *_listMirror;    ///< Media in list order, tells which media a removal index referred to
+    NSMutableArray<VLCMedia *> *_sortedMedia;   ///< Media in view order
+    CFMutableBagRef _members;           ///< Media in _sortedMedia, lets removals skip filtered out media
+    NSComparator _comparator;
+    NSArray<VLCMedia *> *_snapshot;     ///< Lazily built copy of _sortedMedia, dropped on every change
+}
+
+- (instancetype)initWithMediaList:(VLCMediaList *)mediaList
+                  sortDescriptors:(NSArray<NSSortDescriptor *> *)sortDescriptors
+                        predicate:(nullable NSPredicate *)predicate
+{
+    if (self = [super init]) {
+        _mediaList = mediaList;
+        _sortDescriptors = [sortDescriptors copy];
+        _predicate = [predicate copy];
+
+        NSArray<NSSortDescriptor *> *descriptors = _sortDescriptors;
+        _comparator = ^NSComparisonResult(id first, id second) {
+            for (NSSortDescriptor *descriptor in descriptors) {
+                const NSComparisonResult result = [descriptor compareObject:first toObject:second];
+                if (result != NSOrderedSame)
+                    return result;
+            }
+            return NSOrderedSame;
+        };
+        _members = CFBagCreateMutable(kCFAllocatorDefault, 0, NULL);
+        _lock = OS_UNFAIR_LOCK_INIT;
+
+        // not published yet, no need to lock
+        NSUInteger generation;
+        [self rebuildWithMedia:[mediaList mediaWithGeneration:&generation] generation:generation];
+        [mediaList addObserver:self forKeyPath:@"media" options:0 context:VLCMediaListViewContext];
+        // changes made before observing were not notified
+        if (mediaList.mediaGeneration != generation)
+            [self reload];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [_mediaList removeObserver:self forKeyPath:@"media" context:VLCMediaListViewContext];
+    CFRelease(_members);
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@ %p>, count: %lu, sort: %@, predicate: %@", [self class], self, (unsigned long)self.count, _sortDescriptors, _predicate];
+}
+
+#pragma mark - reading
+
+- (NSArray<VLCMedia *> *)media
+{
+    os_unfair_lock_lock(&_lock);
+    if (!_snapshot)
+        _snapshot = [_sortedMedia copy];
+    NSArray<VLCMedia *> *snapshot = _snapshot;
+    os_unfair_lock_unlock(&_lock);
+    return snapshot;
+}
+
+- (NSUInteger)count
+{
+    os_unfair_lock_lock(&_lock);
+    const NSUInteger count = _sortedMedia.count;
+    os_unfair_lock_unlock(&_lock);
+    return count;
+}
+
+- (nullable VLCMedia *)mediaAtIndex:(NSUInteger)index
+{
+    os_unfair_lock_lock(&_lock);
+    VLCMedia *media = index < _sortedMedia.count ? _sortedMedia[index] : nil;
+    os_unfair_lock_unlock(&_lock);
+    return media;
+}
+
+#pragma mark - updating
+
+- (void)reload
+{
+    NSUInteger generation;
+    NSArray<VLCMedia *> *media = [_mediaList mediaWithGeneration:&generation];
+
+    os_unfair_lock_lock(&_lock);
+    // a concurrent reload or change already brought a newer state
+    if (generation < _generation) {
+        os_unfair_lock_unlock(&_lock);
+        return;
+    }
+    NSIndexSet *removedIndexes = [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, _sortedMedia.count)];
+    [self rebuildWithMedia:media generation:generation];
+    NSIndexSet *insertedIndexes = [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, _sortedMedia.count)];
+    os_unfair_lock_unlock(&_lock);
+
+    [self notifyRemovedIndexes:removedIndexes insertedIndexes:insertedIndexes];
+}
+
+- (void)observeValueForKeyPath:(NSString *)keyPath
+                      ofObject:(id)object
+                        change:(NSDictionary<NSKeyValueChangeKey,id> *)change
+                       context:(void *)context
+{
+    if (context != VLCMediaListViewContext) {
+        [super observeValueForKeyPath:keyPath ofObject:object change:change context:context];
+        return;
+    }
+
+    const NSKeyValueChange kind = [change[NSKeyValueChangeKindKey] unsignedIntegerValue];
+    NSIndexSet *indexes = change[NSKeyValueChangeIndexesKey];
+    const NSUInteger changeGeneration = [VLCMediaList notifiedMediaGeneration];
+    if (kind == NSKeyValueChangeSetting || indexes.count == 0 || changeGeneration == NSNotFound) {
+        [self reload];
+        return;
+    }
+
+    // the snapshot the view was built from already holds the change
+    os_unfair_lock_lock(&_lock);
+    const BOOL included = changeGeneration <= _generation;
+    os_unfair_lock_unlock(&_lock);
+    if (included)
+        return;
+
+    // the list does not hold any lock while notifying, fetch the new media first
+    NSMutableArray<VLCMedia *> *newMedia = nil;
+    if (kind == NSKeyValueChangeInsertion || kind == NSKeyValueChangeReplacement) {
+        newMedia = [NSMutableArray arrayWithCapacity:indexes.count];
+        __block BOOL complete = YES;
+        [indexes enumerateIndexesUsingBlock:^(NSUInteger index, BOOL *stop) {
+            VLCMedia *media = [self->_mediaList mediaAtIndex:index];
+            if (!media) {
+                complete = NO;
+                *stop = YES;
+                return;
+            }
+            [newMedia addObject:media];
+        }];
+        // the list changed again in the meantime, the media at these indexes may be other ones
+        if (!complete || _mediaList.mediaGeneration != changeGeneration) {
+            [self reload];
+            return;
+        }
+    }
+
+    NSMutableIndexSet *removedIndexes = [NSMutableIndexSet indexSet];
+    NSMutableIndexSet *insertedIndexes = [NSMutableIndexSet indexSet];
+    BOOL inSync = YES;
+
+    os_unfair_lock_lock(&_lock);
+    if (changeGeneration <= _generation) {
+        // applied by a concurrent reload meanwhile
+        os_unfair_lock_unlock(&_lock);
+        return;
+    }
+    // a change notified out of order or missed, only a snapshot tells the current content
+    if (changeGeneration != _generation + 1) {
+        inSync = NO;
+    } else {
+        switch (kind) {
+            case NSKeyValueChangeInsertion:
+                if (indexes.lastIndex >= _listMirror.count + indexes.count) {
+                    inSync = NO;
+                    break;
+                }
+                [_listMirror insertObjects:newMedia atIndexes:indexes];
+                [self insertMediaIntoView:newMedia insertedIndexes:insertedIndexes];
+                break;
+
+            case NSKeyValueChangeRemoval: {
+                if (indexes.lastIndex >= _listMirror.count) {
+                    inSync = NO;
+                    break;
+                }
+                NSArray<VLCMedia *> *oldMedia = [_listMirror objectsAtIndexes:indexes];
+                [_listMirror removeObjectsAtIndexes:indexes];
+                [self removeMediaFromView:oldMedia removedIndexes:removedIndexes];
+                break;
+            }
+
+            case NSKeyValueChangeReplacement: {
+                if (indexes.lastIndex >= _listMirror.count) {
+                    inSync = NO;
+                    break;
+                }
+                NSArray<VLCMedia *> *oldMedia = [_listMirror objectsAtIndexes:indexes];
+                [_listMirror replaceObjectsAtIndexes:indexes withObjects:newMedia];
+                // moves within the list replace a span with the same media, the sorted order is unaffected
+                if ([[NSCountedSet setWithArray:oldMedia] isEqual:[NSCountedSet setWithArray:newMedia]])
+                    break;
+                [self removeMediaFromView:oldMedia removedIndexes:removedIndexes];
+                [self insertMediaIntoView:newMedia insertedIndexes:insertedIndexes];
+                break;
+            }
+
+            default:
+                inSync = NO;
+                break;
+        }
+    }
+    if (inSync)
+        _generation = changeGeneration;
+    os_unfair_lock_unlock(&_lock);
+
+    if (!inSync) {
+        [self reload];
+        return;
+    }
+    [self notifyRemovedIndexes:removedIndexes insertedIndexes:insertedIndexes];
+}
+
+- (void)notifyRemovedIndexes:(NSIndexSet *)removedIndexes insertedIndexes:(NSIndexSet *)insertedIndexes
+{
+    if (removedIndexes.count == 0 && insertedIndexes.count == 0)
+        return;
+
+    VLCMediaListViewChangeHandler changeHandler = self.changeHandler;
+    if (changeHandler)
+        changeHandler(self, removedIndexes, insertedIndexes);
+}
+
+#pragma mark - private, called with _lock held
+
+- (void)rebuildWithMedia:(NSArray<VLCMedia *> *)media generation:(NSUInteger)generation
+{
+    _generation = generation;
+    _listMirror = [media mutableCopy];
+    NSArray<VLCMedia *> *included = _predicate ? [media filteredArrayUsingPredicate:_predicate] : media;
+    _sortedMedia = [[included sortedArrayWithOptions:NSSortStable usingComparator:_comparator] mutableCopy];
+
+    CFBagRemoveAllValues(_members);
+    for (VLCMedia *item in _sortedMedia)
+        CFBagAddValue(_members, (__bridge const void *)item);
+    _snapshot = nil;
+}
+
+- (void)insertMediaIntoView:(NSArray<VLCMedia *> *)media insertedIndexes:(NSMutableIndexSet *)insertedIndexes
+{
+    NSArray<VLCMedia *> *included = _predicate ? [media filteredArrayUsingPredicate:_predicate] : media;
+    if (included.count == 0)
+        return;
+
+    for (VLCMedia *item in included)
+        CFBagAddValue(_members, (__bridge const void *)item);
+    _snapshot = nil;
+
+    if (included.count <= kBinaryInsertionLimit) {
+        for (VLCMedia *item in included) {
+            // inserting after equal media keeps the list order among them
+            const NSUInteger index = [_sortedMedia indexOfObject:item
+                                                   inSortedRange:NSMakeRange(0, _sortedMedia.count)
+                                                         options:NSBinarySearchingInsertionIndex | NSBinarySearchingLastEqual
+                                                 usingComparator:_comparator];
+            [_sortedMedia insertObject:item atIndex:index];
+            [insertedIndexes shiftIndexesStartingAtIndex:index by:1];
+            [insertedIndexes addIndex:index];
+        }
+        return;
+    }
+
+    NSArray<VLCMedia *> *batch = [included sortedArrayWithOptions:NSSortStable usingComparator:_comparator];
+    NSArray<VLCMedia *> *current = _sortedMedia;
+    const NSUInteger currentCount = current.count, batchCount = batch.count;
+    NSMutableArray<VLCMedia *> *merged = [NSMutableArray arrayWithCapacity:currentCount + batchCount];
+    NSUInteger i = 0, j = 0;
+    while (i < currentCount || j < batchCount) {
+        if (j < batchCount && (i == currentCount || _comparator(batch[j], current[i]) == NSOrderedAscending)) {
+            [insertedIndexes addIndex:merged.count];
+            [merged addObject:batch[j++]];
+        } else {
+            [merged addObject:current[i++]];
+        }
+    }
+    _sortedMedia = merged;
+}
+
+- (void)removeMediaFromView:(NSArray<VLCMedia *> *)media removedIndexes:(NSMutableIndexSet *)removedIndexes
+{
+    for (VLCMedia *item in media) {
+        if (CFBagGetCountOfValue(_members, (__bridge const void *)item) == 0)
+            continue;
+        CFBagRemoveValue(_members, (__bridge const void *)item);
+
+        const NSUInteger index = [self viewIndexOfMedia:item excludingIndexes:removedIndexes];
+        if (index != NSNotFound)
+            [removedIndexes addIndex:index];
+    }
+    if (removedIndexes.count == 0)
+        return;
+
+    [_sortedMedia removeObjectsAtIndexes:removedIndexes];
+    _snapshot = nil;
+}
+
+- (NSUInteger)viewIndexOfMedia:(VLCMedia *)media excludingIndexes:(NSIndexSet *)excludedIndexes
+{
+    const NSUInteger count = _sortedMedia.count;
+    NSUInteger index = [_sortedMedia indexOfObject:media
+                                     inSortedRange:NSMakeRange(0, count)
+                                           options:NSBinarySearchingFirstEqual
+                                   usingComparator:_comparator];
+    if (index != NSNotFound) {
+        for (; index < count && _comparator(_sortedMedia[index], media) == NSOrderedSame; index++) {
+            if (_sortedMedia[index] == media && ![excludedIndexes containsIndex:index])
+                return index;
+        }
+    }
+
+    // the sort keys of the media changed since it was inserted
+    for (index = 0; index < count; index++) {
+        if (_sortedMedia[index] == media && ![excludedIndexes containsIndex:index])
+            return index;
+    }
+    return NSNotFound;
+}
+
+@end
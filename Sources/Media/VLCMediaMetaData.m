@@ -23,24 +23,27 @@
 
 #import <VLCMedia.h>
 #import <VLCLibVLCBridging.h>
+#import <VLCArtworkCache.h>
+
+#include <os/lock.h>
+
+/// number of `libvlc_meta_t` values
+#define VLC_META_COUNT (libvlc_meta_DiscTotal + 1)
 
 @implementation VLCMediaMetaData
 {
     __weak VLCMedia *_media;
-    NSMutableDictionary *_metaCache;
+    os_unfair_lock _metaCacheLock;                  ///< Protects both caches, never held across libvlc calls
+    id _metaCache[VLC_META_COUNT];                  ///< Indexed by libvlc_meta_t, nil until fetched, NSNull if unset
+    NSMutableDictionary<NSString *, id> *_extraCache; ///< Meta extra by name, created on first use
     VLCPlatformImage * _Nullable _artwork;
-    dispatch_queue_t _metaCacheAccessQueue;
 }
 
 - (instancetype)initWithMedia:(VLCMedia *)media
 {
     if (self = [super init]) {
         _media = media;
-        _metaCache = [NSMutableDictionary dictionary];
-        dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_CONCURRENT,
-                                                                             QOS_CLASS_UTILITY,
-                                                                             0);
-        _metaCacheAccessQueue = dispatch_queue_create("VLCKit.VLCMediaMetaData.metaCacheAccessQueue", attr);
+        _metaCacheLock = OS_UNFAIR_LOCK_INIT;
     }
     return self;
 }
@@ -316,6 +319,19 @@
     return _artwork;
 }
 
+- (void)artworkWithSize:(CGSize)size
+      completionHandler:(void (^)(VLCPlatformImage * _Nullable artwork))completionHandler
+{
+    NSURL *artURL = self.artworkURL;
+    if (!artURL.isFileURL) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completionHandler(nil);
+        });
+        return;
+    }
+    [VLCArtworkCache.sharedCache loadImageForURL: artURL size: size completionHandler: completionHandler];
+}
+
 - (nullable NSString *)extraValueForKey:(NSString *)key
 {
     return [self extraCacheValueForKey: key];
@@ -358,16 +374,74 @@
 
 - (void)prefetch
 {
-    // 26 = `libvlc_meta_t` all count
-    for (libvlc_meta_t meta_t = 0; meta_t < 26; meta_t++)
+    for (libvlc_meta_t meta_t = 0; meta_t < VLC_META_COUNT; meta_t++)
         [self fetchMetaDataForKey: meta_t];
 }
 
+- (VLCMediaMetaDataSnapshot *)snapshot
+{
+    id cache[VLC_META_COUNT];
+    os_unfair_lock_lock(&_metaCacheLock);
+    for (libvlc_meta_t meta_t = 0; meta_t < VLC_META_COUNT; meta_t++)
+        cache[meta_t] = _metaCache[meta_t];
+    NSDictionary<NSString *, id> *extraCache = [_extraCache copy];
+    os_unfair_lock_unlock(&_metaCacheLock);
+
+    // everything missing from the cache is fetched here and stored at once below
+    id fetched[VLC_META_COUNT] = { nil };
+    NSMutableDictionary<NSString *, id> *fetchedExtra = [NSMutableDictionary dictionary];
+
+    NSMutableDictionary<NSNumber *, id> *values = [NSMutableDictionary dictionaryWithCapacity: VLC_META_COUNT];
+    for (libvlc_meta_t meta_t = 0; meta_t < VLC_META_COUNT; meta_t++) {
+        id value = cache[meta_t];
+        if (!value && (value = [self metaValueForKey: meta_t]))
+            fetched[meta_t] = value;
+        if (value && value != NSNull.null)
+            values[@(meta_t)] = value;
+    }
+
+    NSMutableDictionary<NSString *, NSString *> *extra = [NSMutableDictionary dictionary];
+    libvlc_media_t *media_t = (libvlc_media_t *)_media.libVLCMediaDescriptor;
+    char **ppsz_names = NULL;
+    const unsigned count = media_t ? libvlc_media_get_meta_extra_names(media_t, &ppsz_names) : 0;
+    for (unsigned i = 0; i < count; i++) {
+        NSString *key = @(ppsz_names[i]);
+        id value = extraCache[key];
+        if (!value && (value = [self metaExtraForKey: key]))
+            fetchedExtra[key] = value;
+        if ([value isKindOfClass: NSString.class])
+            extra[key] = value;
+    }
+    if (count > 0)
+        libvlc_media_meta_extra_names_release(ppsz_names, count);
+
+    // a setter may have run while we were fetching, its value wins
+    os_unfair_lock_lock(&_metaCacheLock);
+    for (libvlc_meta_t meta_t = 0; meta_t < VLC_META_COUNT; meta_t++)
+        if (fetched[meta_t] && !_metaCache[meta_t])
+            _metaCache[meta_t] = fetched[meta_t];
+    if (fetchedExtra.count > 0) {
+        if (!_extraCache)
+            _extraCache = [NSMutableDictionary dictionary];
+        for (NSString *key in fetchedExtra)
+            if (!_extraCache[key])
+                _extraCache[key] = fetchedExtra[key];
+    }
+    os_unfair_lock_unlock(&_metaCacheLock);
+
+    return [[VLCMediaMetaDataSnapshot alloc] initWithValues: values extra: extra];
+}
+
 - (void)clearCache
 {
-    dispatch_barrier_async(_metaCacheAccessQueue, ^{
-        [_metaCache removeAllObjects];
-    });
+    os_unfair_lock_lock(&_metaCacheLock);
+    for (libvlc_meta_t meta_t = 0; meta_t < VLC_META_COUNT; meta_t++)
+        _metaCache[meta_t] = nil;
+    // keep the extra values alive until the lock is released
+    NSMutableDictionary *extraCache = _extraCache;
+    _extraCache = nil;
+    os_unfair_lock_unlock(&_metaCacheLock);
+    (void)extraCache;
 }
 
 
@@ -385,6 +459,19 @@
 /* fetch and cache */
 
 - (nullable id)fetchMetaDataForKey:(const libvlc_meta_t)key
+{
+    id value = [self metaValueForKey: key];
+
+    if (value && key < VLC_META_COUNT) {
+        os_unfair_lock_lock(&_metaCacheLock);
+        _metaCache[key] = value;
+        os_unfair_lock_unlock(&_metaCacheLock);
+    }
+
+    return value;
+}
+
+- (nullable id)metaValueForKey:(const libvlc_meta_t)key
 {
     id value = nil;
     
@@ -432,12 +519,7 @@
             VKLog(@"WARNING: undefined meta type : %d", key);
             break;
     }
-    
-    if (value)
-        dispatch_barrier_async(_metaCacheAccessQueue, ^{
-            _metaCache[@(key)] = value;
-        });
-    
+
     return value;
 }
 
@@ -445,11 +527,13 @@
 
 - (nullable id)cacheValueForKey:(const libvlc_meta_t)key
 {
-    __block id cacheValue = nil;
-    dispatch_sync(_metaCacheAccessQueue, ^{
-        cacheValue = _metaCache[@(key)];
-    });
-    
+    if (key >= VLC_META_COUNT)
+        return nil;
+
+    os_unfair_lock_lock(&_metaCacheLock);
+    id cacheValue = _metaCache[key];
+    os_unfair_lock_unlock(&_metaCacheLock);
+
     if (!cacheValue)
         cacheValue = [self fetchMetaDataForKey: key];
     
@@ -543,10 +627,12 @@
         return;
     
     libvlc_media_set_meta(media_t, key, data);
-    
-    dispatch_barrier_async(_metaCacheAccessQueue, ^{
-        [_metaCache removeObjectForKey: @(key)];
-    });
+
+    if (key < VLC_META_COUNT) {
+        os_unfair_lock_lock(&_metaCacheLock);
+        _metaCache[key] = nil;
+        os_unfair_lock_unlock(&_metaCacheLock);
+    }
 }
 
 - (void)setString:(nullable NSString *)str forKey:(const libvlc_meta_t)key
@@ -573,15 +659,17 @@
     if (!key)
         return nil;
     
-    __block id cacheValue = nil;
-    dispatch_sync(_metaCacheAccessQueue, ^{
-        cacheValue = _metaCache[key];
-    });
-    
-    if (!cacheValue && (cacheValue = [self metaExtraForKey: key]))
-        dispatch_barrier_async(_metaCacheAccessQueue, ^{
-            _metaCache[key] = cacheValue;
-        });
+    os_unfair_lock_lock(&_metaCacheLock);
+    id cacheValue = _extraCache[key];
+    os_unfair_lock_unlock(&_metaCacheLock);
+
+    if (!cacheValue && (cacheValue = [self metaExtraForKey: key])) {
+        os_unfair_lock_lock(&_metaCacheLock);
+        if (!_extraCache)
+            _extraCache = [NSMutableDictionary dictionary];
+        _extraCache[key] = cacheValue;
+        os_unfair_lock_unlock(&_metaCacheLock);
+    }
     
     if ([cacheValue isKindOfClass: NSString.class])
         return (NSString *)cacheValue;
@@ -620,10 +708,187 @@
         return;
     
     libvlc_media_set_meta_extra(media_t, key.UTF8String, value.UTF8String);
-    
-    dispatch_barrier_async(_metaCacheAccessQueue, ^{
-        [_metaCache removeObjectForKey: key];
-    });
+
+    os_unfair_lock_lock(&_metaCacheLock);
+    [_extraCache removeObjectForKey: key];
+    os_unfair_lock_unlock(&_metaCacheLock);
+}
+
+@end
+
+/******************************************************************************
+ * Implementation VLCMediaMetaDataSnapshot
+ */
+@implementation VLCMediaMetaDataSnapshot
+{
+    NSDictionary<NSNumber *, id> *_values;
+}
+
+- (instancetype)initWithValues:(NSDictionary<NSNumber *, id> *)values extra:(NSDictionary<NSString *, NSString *> *)extra
+{
+    if (self = [super init]) {
+        _values = [values copy];
+        _extra = [extra copy];
+    }
+    return self;
+}
+
+- (id)copyWithZone:(nullable NSZone *)zone
+{
+    return self;
+}
+
+- (nullable NSString *)title
+{
+    return [self stringForKey: libvlc_meta_Title];
+}
+
+- (nullable NSString *)artist
+{
+    return [self stringForKey: libvlc_meta_Artist];
+}
+
+- (nullable NSString *)genre
+{
+    return [self stringForKey: libvlc_meta_Genre];
+}
+
+- (nullable NSString *)copyright
+{
+    return [self stringForKey: libvlc_meta_Copyright];
+}
+
+- (nullable NSString *)album
+{
+    return [self stringForKey: libvlc_meta_Album];
+}
+
+- (unsigned)trackNumber
+{
+    return [self unsignedForKey: libvlc_meta_TrackNumber];
+}
+
+- (nullable NSString *)metaDescription
+{
+    return [self stringForKey: libvlc_meta_Description];
+}
+
+- (nullable NSString *)rating
+{
+    return [self stringForKey: libvlc_meta_Rating];
+}
+
+- (nullable NSString *)date
+{
+    return [self stringForKey: libvlc_meta_Date];
+}
+
+- (nullable NSString *)setting
+{
+    return [self stringForKey: libvlc_meta_Setting];
+}
+
+- (nullable NSURL *)url
+{
+    return [self urlForKey: libvlc_meta_URL];
+}
+
+- (nullable NSString *)language
+{
+    return [self stringForKey: libvlc_meta_Language];
+}
+
+- (nullable NSString *)nowPlaying
+{
+    return [self stringForKey: libvlc_meta_NowPlaying];
+}
+
+- (nullable NSString *)publisher
+{
+    return [self stringForKey: libvlc_meta_Publisher];
+}
+
+- (nullable NSString *)encodedBy
+{
+    return [self stringForKey: libvlc_meta_EncodedBy];
+}
+
+- (nullable NSURL *)artworkURL
+{
+    return [self urlForKey: libvlc_meta_ArtworkURL];
+}
+
+- (unsigned)trackID
+{
+    return [self unsignedForKey: libvlc_meta_TrackID];
+}
+
+- (unsigned)trackTotal
+{
+    return [self unsignedForKey: libvlc_meta_TrackTotal];
+}
+
+- (nullable NSString *)director
+{
+    return [self stringForKey: libvlc_meta_Director];
+}
+
+- (unsigned)season
+{
+    return [self unsignedForKey: libvlc_meta_Season];
+}
+
+- (unsigned)episode
+{
+    return [self unsignedForKey: libvlc_meta_Episode];
+}
+
+- (nullable NSString *)showName
+{
+    return [self stringForKey: libvlc_meta_ShowName];
+}
+
+- (nullable NSString *)actors
+{
+    return [self stringForKey: libvlc_meta_Actors];
+}
+
+- (nullable NSString *)albumArtist
+{
+    return [self stringForKey: libvlc_meta_AlbumArtist];
+}
+
+- (unsigned)discNumber
+{
+    return [self unsignedForKey: libvlc_meta_DiscNumber];
+}
+
+- (unsigned)discTotal
+{
+    return [self unsignedForKey: libvlc_meta_DiscTotal];
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@ %p>, title: %@, artist: %@, genre: %@, copyright: %@, album: %@, trackNumber: %u, metaDescription: %@, rating: %@, date: %@, setting: %@, url: %@, language: %@, nowPlaying: %@, publisher: %@, encodedBy: %@, artworkURL: %@, trackID: %u, trackTotal: %u, director: %@, season: %u, episode: %u, showName: %@, actors: %@, albumArtist: %@, discNumber: %u, discTotal: %u, extra: %@", [self class], self, [self title], [self artist], [self genre], [self copyright], [self album], [self trackNumber], [self metaDescription], [self rating], [self date], [self setting], [self url], [self language], [self nowPlaying], [self publisher], [self encodedBy], [self artworkURL], [self trackID], [self trackTotal], [self director], [self season], [self episode], [self showName], [self actors], [self albumArtist], [self discNumber], [self discTotal], _extra];
+}
+
+- (nullable NSString *)stringForKey:(const libvlc_meta_t)key
+{
+    id value = _values[@(key)];
+    return [value isKindOfClass: NSString.class] ? value : nil;
+}
+
+- (nullable NSURL *)urlForKey:(const libvlc_meta_t)key
+{
+    id value = _values[@(key)];
+    return [value isKindOfClass: NSURL.class] ? value : nil;
+}
+
+- (unsigned)unsignedForKey:(const libvlc_meta_t)key
+{
+    id value = _values[@(key)];
+    return [value isKindOfClass: NSNumber.class] ? [value unsignedIntValue] : 0;
 }
 
 @end
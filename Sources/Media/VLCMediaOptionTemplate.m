@@ -0,0 +1,118 @@
+/*****************************************************************************
+ * VLCMediaOptionTemplate.m: VLCKit.framework VLCMediaOptionTemplate implementation
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#import <VLCMediaOptionTemplate.h>
+#import <VLCMedia.h>
+#import <VLCLibVLCBridging.h>
+
+#include <vlc/vlc.h>
+
+@implementation VLCMediaOptionTemplate
+{
+    char **_options;        ///< Points into _storage, one entry per option
+    char *_storage;         ///< All options, NUL-separated, in a single allocation
+}
+
+- (instancetype)initWithOptions:(NSDictionary<NSString *, id> *)options
+{
+    NSMutableArray<NSString *> *optionStrings = [NSMutableArray arrayWithCapacity: options.count];
+    [options enumerateKeysAndObjectsUsingBlock:^(NSString *key, id obj, BOOL *stop) {
+        if (![obj isKindOfClass:[NSNull class]])
+            [optionStrings addObject: [NSString stringWithFormat:@"%@=%@", key, obj]];
+        else
+            [optionStrings addObject: key];
+    }];
+    return [self initWithOptionStrings: optionStrings];
+}
+
+- (instancetype)initWithOptionStrings:(NSArray<NSString *> *)optionStrings
+{
+    if (self = [super init]) {
+        _optionStrings = [optionStrings copy];
+        _count = _optionStrings.count;
+
+        size_t storageSize = 0;
+        for (NSString *option in _optionStrings)
+            storageSize += [option lengthOfBytesUsingEncoding: NSUTF8StringEncoding] + 1;
+
+        _options = calloc(_count ? _count : 1, sizeof(*_options));
+        _storage = malloc(storageSize ? storageSize : 1);
+        if (!_options || !_storage)
+            return nil;
+
+        char *cursor = _storage;
+        for (NSUInteger i = 0; i < _count; i++) {
+            NSString *option = _optionStrings[i];
+            const NSUInteger length = [option lengthOfBytesUsingEncoding: NSUTF8StringEncoding];
+            [option getBytes: cursor
+                   maxLength: length
+                  usedLength: NULL
+                    encoding: NSUTF8StringEncoding
+                     options: 0
+                       range: NSMakeRange(0, option.length)
+              remainingRange: NULL];
+            cursor[length] = '\0';
+            _options[i] = cursor;
+            cursor += length + 1;
+        }
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    free(_options);
+    free(_storage);
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@ %p>, options: %@", [self class], self, _optionStrings];
+}
+
+- (void)applyToMedia:(VLCMedia *)media
+{
+    [self applyToLibVLCMediaDescriptor: [media libVLCMediaDescriptor]];
+    [media recordLibVLCOptions: _optionStrings];
+}
+
+- (void)applyToMediaArray:(NSArray<VLCMedia *> *)mediaArray
+{
+    for (VLCMedia *media in mediaArray)
+        [self applyToMedia: media];
+}
+
+@end
+
+@implementation VLCMediaOptionTemplate (LibVLCBridging)
+
+- (void)applyToLibVLCMediaDescriptor:(libvlc_media_t *)md
+{
+    if (!md)
+        return;
+
+    for (NSUInteger i = 0; i < _count; i++)
+        libvlc_media_add_option(md, _options[i]);
+}
+
+@end
@@ -0,0 +1,263 @@
+/*****************************************************************************
+ * VLCMediaStatsSampler.m: VLCKit.framework VLCMediaStatsSampler implementation
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#import <VLCMediaStatsSampler.h>
+#import <VLCMediaStatsSampler+Internal.h>
+#import <VLCMedia.h>
+#import <VLCLibVLCBridging.h>
+
+#include <vlc/vlc.h>
+#include <os/lock.h>
+#include <float.h>
+
+static const NSTimeInterval kMinimumInterval = 0.1;
+static const NSTimeInterval kDefaultInterval = 1.0;
+static const NSUInteger kDefaultCapacity = 60;
+
+/// one entry of the ring buffer, rates are derived from the previous raw counters
+typedef struct {
+    int64_t date_us;
+    double values[VLCMediaStatsMetricCount];
+} vlc_stats_sample_t;
+
+/// shared by all samplers so that many of them only cost one timer each
+static dispatch_queue_t VLCMediaStatsSamplerQueue(void)
+{
+    static dispatch_queue_t queue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL,
+                                                                             QOS_CLASS_UTILITY,
+                                                                             0);
+        queue = dispatch_queue_create("org.videolan.VLCMediaStatsSampler", attr);
+    });
+    return queue;
+}
+
+static inline double CounterRate(int64_t current, int64_t previous, double seconds)
+{
+    // counters restart from zero when the media is played again
+    return current >= previous ? (double)(current - previous) / seconds : 0.;
+}
+
+@implementation VLCMediaStatsSampler
+{
+    dispatch_source_t _timer;
+    os_unfair_lock _lock;               ///< Protects the ring and the previous counters
+    vlc_stats_sample_t *_ring;
+    NSUInteger _head;                   ///< Index of the next write
+    NSUInteger _count;
+    int64_t _previousCounters[VLCMediaStatsMetricCount];
+    int64_t _previousDate_us;           ///< 0 until a first reference sample was taken
+}
+
+- (instancetype)initWithMedia:(VLCMedia *)media
+{
+    return [self initWithMedia:media interval:kDefaultInterval capacity:kDefaultCapacity];
+}
+
+- (instancetype)initWithMedia:(VLCMedia *)media interval:(NSTimeInterval)interval capacity:(NSUInteger)capacity
+{
+    if (self = [super init]) {
+        _media = media;
+        _interval = MAX(interval, kMinimumInterval);
+        _capacity = MAX(capacity, 2);
+        _ring = calloc(_capacity, sizeof(*_ring));
+        if (!_ring)
+            return nil;
+        _lock = OS_UNFAIR_LOCK_INIT;
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    if (_timer)
+        dispatch_source_cancel(_timer);
+    free(_ring);
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@ %p>, media: %@, interval: %f, samples: %lu/%lu", [self class], self, _media, _interval, (unsigned long)self.sampleCount, (unsigned long)_capacity];
+}
+
+#pragma mark - sampling
+
+- (BOOL)isRunning
+{
+    return _timer != nil;
+}
+
+- (void)start
+{
+    if (_timer)
+        return;
+
+    _timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, VLCMediaStatsSamplerQueue());
+    const uint64_t interval_ns = (uint64_t)(_interval * NSEC_PER_SEC);
+    // a generous leeway lets the system coalesce the wake-ups of many samplers
+    dispatch_source_set_timer(_timer, dispatch_time(DISPATCH_TIME_NOW, 0), interval_ns, interval_ns / 10);
+    __weak typeof(self) weakSelf = self;
+    dispatch_source_set_event_handler(_timer, ^{
+        [weakSelf takeSample];
+    });
+    dispatch_resume(_timer);
+}
+
+- (void)stop
+{
+    if (!_timer)
+        return;
+
+    dispatch_source_cancel(_timer);
+    _timer = nil;
+
+    // the next start must not derive rates across the pause
+    os_unfair_lock_lock(&_lock);
+    _previousDate_us = 0;
+    os_unfair_lock_unlock(&_lock);
+}
+
+- (void)reset
+{
+    os_unfair_lock_lock(&_lock);
+    _head = 0;
+    _count = 0;
+    _previousDate_us = 0;
+    os_unfair_lock_unlock(&_lock);
+}
+
+- (void)takeSample
+{
+    libvlc_media_t *p_md = [_media libVLCMediaDescriptor];
+    libvlc_media_stats_t stats;
+    if (!p_md || !libvlc_media_get_stats(p_md, &stats))
+        return;
+
+    int64_t counters[VLCMediaStatsMetricCount];
+    counters[VLCMediaStatsMetricInputBitrate] = stats.i_read_bytes;
+    counters[VLCMediaStatsMetricDemuxBitrate] = stats.i_demux_read_bytes;
+    counters[VLCMediaStatsMetricDemuxCorruptionRate] = stats.i_demux_corrupted;
+    counters[VLCMediaStatsMetricDecodedVideoRate] = stats.i_decoded_video;
+    counters[VLCMediaStatsMetricDecodedAudioRate] = stats.i_decoded_audio;
+    counters[VLCMediaStatsMetricDisplayedPictureRate] = stats.i_displayed_pictures;
+    counters[VLCMediaStatsMetricDroppedPictureRate] = (int64_t)stats.i_late_pictures + stats.i_lost_pictures;
+    counters[VLCMediaStatsMetricLostAudioBufferRate] = stats.i_lost_abuffers;
+
+    [self addSampleWithCounters:counters date:libvlc_clock()];
+}
+
+- (void)addSampleWithCounters:(const int64_t *)counters date:(int64_t)date_us
+{
+    os_unfair_lock_lock(&_lock);
+    const int64_t previousDate_us = _previousDate_us;
+    int64_t previous[VLCMediaStatsMetricCount];
+    memcpy(previous, _previousCounters, sizeof(previous));
+    memcpy(_previousCounters, counters, sizeof(_previousCounters));
+    _previousDate_us = date_us;
+
+    if (previousDate_us == 0 || date_us <= previousDate_us) {
+        os_unfair_lock_unlock(&_lock);
+        return;
+    }
+
+    const double seconds = (date_us - previousDate_us) / 1000000.;
+    vlc_stats_sample_t *sample = &_ring[_head];
+    sample->date_us = date_us;
+    for (NSUInteger i = 0; i < VLCMediaStatsMetricCount; i++)
+        sample->values[i] = CounterRate(counters[i], previous[i], seconds);
+    sample->values[VLCMediaStatsMetricInputBitrate] *= 8.;
+    sample->values[VLCMediaStatsMetricDemuxBitrate] *= 8.;
+
+    _head = (_head + 1) % _capacity;
+    if (_count < _capacity)
+        _count++;
+    os_unfair_lock_unlock(&_lock);
+
+    void (^sampleHandler)(VLCMediaStatsSampler *) = self.sampleHandler;
+    if (sampleHandler)
+        sampleHandler(self);
+}
+
+#pragma mark - reading
+
+- (NSUInteger)sampleCount
+{
+    os_unfair_lock_lock(&_lock);
+    const NSUInteger count = _count;
+    os_unfair_lock_unlock(&_lock);
+    return count;
+}
+
+- (double)latestValueForMetric:(VLCMediaStatsMetric)metric
+{
+    if (metric >= VLCMediaStatsMetricCount)
+        return 0.;
+
+    double value = 0.;
+    os_unfair_lock_lock(&_lock);
+    if (_count > 0)
+        value = _ring[(_head + _capacity - 1) % _capacity].values[metric];
+    os_unfair_lock_unlock(&_lock);
+    return value;
+}
+
+- (VLCMediaStatsWindow)windowForMetric:(VLCMediaStatsMetric)metric
+{
+    return [self windowForMetric:metric duration:DBL_MAX];
+}
+
+- (VLCMediaStatsWindow)windowForMetric:(VLCMediaStatsMetric)metric duration:(NSTimeInterval)duration
+{
+    VLCMediaStatsWindow window = { 0., 0., 0., 0 };
+    if (metric >= VLCMediaStatsMetricCount || duration <= 0.)
+        return window;
+
+    double sum = 0.;
+    os_unfair_lock_lock(&_lock);
+    if (_count > 0) {
+        const int64_t latest_us = _ring[(_head + _capacity - 1) % _capacity].date_us;
+        const double span_us = duration * 1000000.;
+        // walk back from the newest sample, the ring is ordered by date
+        for (NSUInteger i = 1; i <= _count; i++) {
+            const vlc_stats_sample_t *sample = &_ring[(_head + _capacity - i) % _capacity];
+            if ((double)(latest_us - sample->date_us) > span_us)
+                break;
+            const double value = sample->values[metric];
+            if (window.sampleCount == 0 || value < window.minimum)
+                window.minimum = value;
+            if (window.sampleCount == 0 || value > window.maximum)
+                window.maximum = value;
+            sum += value;
+            window.sampleCount++;
+        }
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    if (window.sampleCount > 0)
+        window.average = sum / window.sampleCount;
+    return window;
+}
+
+@end
@@ -0,0 +1,210 @@
+/*****************************************************************************
+ * VLCMetadataWriter.m: VLCKit.framework VLCMetadataWriter implementation
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#import <VLCMetadataWriter.h>
+#import <VLCMedia.h>
+#import <VLCMediaMetaData.h>
+#import <VLCLibVLCBridging.h>
+
+#include <os/lock.h>
+
+static const NSUInteger kDefaultMaximumConcurrentSaves = 4;
+
+typedef void (^VLCMetadataWriterEdit)(VLCMediaMetaData *metaData);
+
+/**
+ * All the work queued for one media until a worker picks it up
+ */
+@interface VLCMetadataWriterItem : NSObject
+{
+@public
+    VLCMedia *_media;
+    NSMutableArray<VLCMetadataWriterEdit> *_edits;
+    NSMutableArray<VLCMetadataWriterCompletionHandler> *_completionHandlers;
+}
+@end
+
+@implementation VLCMetadataWriterItem
+@end
+
+@implementation VLCMetadataWriter
+{
+    os_unfair_lock _lock;               ///< Protects the queue and the worker count
+    NSMutableArray<VLCMetadataWriterItem *> *_queue;
+    NSMutableDictionary<NSValue *, VLCMetadataWriterItem *> *_pendingItems; ///< Keyed by libvlc_media_t
+    NSMutableSet<NSValue *> *_savingKeys;   ///< Media being written, their new items wait for the save to end
+    NSUInteger _activeWorkers;
+    dispatch_queue_t _workQueue;
+}
+
+- (instancetype)init
+{
+    const NSUInteger processorCount = [NSProcessInfo processInfo].activeProcessorCount;
+    return [self initWithMaximumConcurrentSaves:MIN(processorCount, kDefaultMaximumConcurrentSaves)];
+}
+
+- (instancetype)initWithMaximumConcurrentSaves:(NSUInteger)maximumConcurrentSaves
+{
+    if (self = [super init]) {
+        _maximumConcurrentSaves = MAX(maximumConcurrentSaves, 1);
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _queue = [NSMutableArray array];
+        _pendingItems = [NSMutableDictionary dictionary];
+        _savingKeys = [NSMutableSet set];
+        dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_CONCURRENT,
+                                                                             QOS_CLASS_UTILITY,
+                                                                             0);
+        _workQueue = dispatch_queue_create("org.videolan.VLCMetadataWriter", attr);
+    }
+    return self;
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@ %p>, pending: %lu, workers: %lu", [self class], self, (unsigned long)self.pendingCount, (unsigned long)_maximumConcurrentSaves];
+}
+
+- (NSUInteger)pendingCount
+{
+    os_unfair_lock_lock(&_lock);
+    const NSUInteger pendingCount = _pendingItems.count;
+    os_unfair_lock_unlock(&_lock);
+    return pendingCount;
+}
+
+#pragma mark - queueing
+
+- (void)updateMedia:(VLCMedia *)media
+          withBlock:(VLCMetadataWriterEdit)edit
+  completionHandler:(nullable VLCMetadataWriterCompletionHandler)completionHandler
+{
+    [self enqueueMediaArray:@[media] edit:edit completionHandler:completionHandler];
+}
+
+- (void)saveMedia:(VLCMedia *)media
+completionHandler:(nullable VLCMetadataWriterCompletionHandler)completionHandler
+{
+    [self enqueueMediaArray:@[media] edit:nil completionHandler:completionHandler];
+}
+
+- (void)saveMediaArray:(NSArray<VLCMedia *> *)mediaArray
+     completionHandler:(nullable VLCMetadataWriterCompletionHandler)completionHandler
+{
+    [self enqueueMediaArray:mediaArray edit:nil completionHandler:completionHandler];
+}
+
+- (void)enqueueMediaArray:(NSArray<VLCMedia *> *)mediaArray
+                     edit:(nullable VLCMetadataWriterEdit)edit
+        completionHandler:(nullable VLCMetadataWriterCompletionHandler)completionHandler
+{
+    NSUInteger workersToStart = 0;
+
+    os_unfair_lock_lock(&_lock);
+    for (VLCMedia *media in mediaArray) {
+        void *p_md = media.libVLCMediaDescriptor;
+        if (!p_md)
+            continue;
+
+        NSValue *key = [NSValue valueWithPointer:p_md];
+        VLCMetadataWriterItem *item = _pendingItems[key];
+        if (!item) {
+            item = [[VLCMetadataWriterItem alloc] init];
+            item->_media = media;
+            item->_edits = [NSMutableArray array];
+            item->_completionHandlers = [NSMutableArray array];
+            _pendingItems[key] = item;
+            // a media is never written by two workers at once, the follow-up save is queued once the current one ends
+            if (![_savingKeys containsObject:key])
+                [_queue addObject:item];
+        }
+        if (edit)
+            [item->_edits addObject:edit];
+        if (completionHandler)
+            [item->_completionHandlers addObject:completionHandler];
+    }
+    while (_activeWorkers < _maximumConcurrentSaves && _activeWorkers + workersToStart < _queue.count) {
+        _activeWorkers++;
+        workersToStart++;
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    for (NSUInteger i = 0; i < workersToStart; i++)
+        dispatch_async(_workQueue, ^{
+            [self runWorker];
+        });
+}
+
+- (void)cancelPendingSaves
+{
+    os_unfair_lock_lock(&_lock);
+    [_queue removeAllObjects];
+    [_pendingItems removeAllObjects];
+    os_unfair_lock_unlock(&_lock);
+}
+
+#pragma mark - workers
+
+/// saves queued items until the queue is empty, never more than maximumConcurrentSaves run at once
+- (void)runWorker
+{
+    for (;;) {
+        os_unfair_lock_lock(&_lock);
+        VLCMetadataWriterItem *item = _queue.firstObject;
+        if (!item) {
+            _activeWorkers--;
+            os_unfair_lock_unlock(&_lock);
+            return;
+        }
+        [_queue removeObjectAtIndex:0];
+        // edits queued from now on start a new item, saved after this one
+        NSValue *key = [NSValue valueWithPointer:item->_media.libVLCMediaDescriptor];
+        [_pendingItems removeObjectForKey:key];
+        [_savingKeys addObject:key];
+        os_unfair_lock_unlock(&_lock);
+
+        @autoreleasepool {
+            VLCMediaMetaData *metaData = item->_media.metaData;
+            for (VLCMetadataWriterEdit edit in item->_edits)
+                edit(metaData);
+            const BOOL success = [metaData save];
+
+            os_unfair_lock_lock(&_lock);
+            [_savingKeys removeObject:key];
+            VLCMetadataWriterItem *followUp = _pendingItems[key];
+            if (followUp)
+                [_queue addObject:followUp];
+            os_unfair_lock_unlock(&_lock);
+
+            NSArray<VLCMetadataWriterCompletionHandler> *completionHandlers = item->_completionHandlers;
+            if (completionHandlers.count > 0) {
+                VLCMedia *media = item->_media;
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    for (VLCMetadataWriterCompletionHandler completionHandler in completionHandlers)
+                        completionHandler(media, success);
+                });
+            }
+        }
+    }
+}
+
+@end
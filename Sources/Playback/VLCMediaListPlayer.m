@@ -29,9 +29,24 @@
 #import <VLCMedia.h>
 #import <VLCMediaPlayer.h>
 #import <VLCMediaList.h>
+#import <VLCMediaList+Internal.h>
+#import <VLCMediaListShuffleDeck.h>
 #import <VLCLibVLCBridging.h>
 #import <VLCLibrary.h>
 #import <VLCEventsHandler.h>
+#import <VLCTime.h>
+
+#include <vlc/vlc.h>
+#include <os/lock.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+static const NSTimeInterval kDefaultPreparationInterval = 10.;
+static const off_t kPrefetchHeadSize = 4 * 1024 * 1024;
+static const off_t kPrefetchTailSize = 1024 * 1024;
+static const NSUInteger kDefaultShuffleHistoryLimit = 100;
+
+static void *VLCMediaListPlayerContext = &VLCMediaListPlayerContext;
 
 @interface VLCMediaListPlayer () {
     void *instance;
@@ -41,10 +56,26 @@
     VLCRepeatMode _repeatMode;
     dispatch_queue_t _libVLCBackgroundQueue;
     VLCEventsHandler* _eventsHandler;
+
+    os_unfair_lock _shuffleLock;                ///< Protects the ivars below and the writes of _mediaList
+    BOOL _shuffleEnabled;
+    VLCMediaList *_shuffleList;                 ///< Holds the shuffled item being played, nil when playing from _mediaList
+    VLCMedia *_shuffledMedia;                   ///< Item of _shuffleList, nil until the first shuffled pick
+    VLCMediaListShuffleDeck *_shuffleDeck;      ///< Follows the indexes of _mediaList
+    NSUInteger _shuffleDeckGeneration;          ///< Generation of _mediaList the deck is at, NSNotFound if out of sync
+
+    os_unfair_lock _transitionLock;             ///< Protects the ivars below
+    VLCMedia *_preparationTrigger;              ///< Current item whose successor was prepared
+    int64_t _itemEndClock;                      ///< libvlc_clock() when the previous item stopped, 0 if none
+    NSTimeInterval _lastTransitionGap;
+    NSTimeInterval _totalTransitionGap;
+    NSUInteger _transitionCount;
 }
 - (void)mediaListPlayerPlayed;
 - (void)mediaListPlayerNextItemSet:(VLCMedia *)media;
 - (void)mediaListPlayerStopped;
+- (void)mediaPlayerStateChanged:(NSNotification *)aNotification;
+- (void)mediaPlayerTimeChanged:(NSNotification *)aNotification;
 @end
 
 static void HandleMediaListPlayerPlayed(const libvlc_event_t * event, void * opaque)
@@ -101,6 +132,12 @@ static void HandleMediaListPlayerStopped(const libvlc_event_t * event, void * op
         if (drawable != nil)
             [_mediaPlayer setDrawable:drawable];
 
+        _preparationInterval = kDefaultPreparationInterval;
+        _transitionLock = OS_UNFAIR_LOCK_INIT;
+        _shuffleLock = OS_UNFAIR_LOCK_INIT;
+        _shuffleDeck = [[VLCMediaListShuffleDeck alloc] initWithCount:0 historyLimit:kDefaultShuffleHistoryLimit];
+        _shuffleDeckGeneration = NSNotFound;
+
         [self registerObservers];
     }
     return self;
@@ -123,10 +160,23 @@ static void HandleMediaListPlayerStopped(const libvlc_event_t * event, void * op
         libvlc_event_attach(p_em, libvlc_MediaListPlayerStopped,
                             HandleMediaListPlayerStopped, (__bridge void *)(_eventsHandler));
     });
+
+    // notifications leave the delegate of the media player to the application
+    NSNotificationCenter *center = [NSNotificationCenter defaultCenter];
+    [center addObserver:self
+               selector:@selector(mediaPlayerStateChanged:)
+                   name:VLCMediaPlayerStateChangedNotification
+                 object:_mediaPlayer];
+    [center addObserver:self
+               selector:@selector(mediaPlayerTimeChanged:)
+                   name:VLCMediaPlayerTimeChangedNotification
+                 object:_mediaPlayer];
 }
 
 - (void)unregisterObservers
 {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+
     libvlc_event_manager_t * p_em = libvlc_media_list_player_event_manager(instance);
 
     if (!p_em) {
@@ -159,6 +209,7 @@ static void HandleMediaListPlayerStopped(const libvlc_event_t * event, void * op
 - (void)dealloc
 {
     [_mediaPlayer stop];
+    [_mediaList removeObserver:self forKeyPath:@"media" context:VLCMediaListPlayerContext];
     [self unregisterObservers];
     libvlc_media_list_player_release(instance);
 }
@@ -172,9 +223,20 @@ static void HandleMediaListPlayerStopped(const libvlc_event_t * event, void * op
 {
     if (_mediaList == mediaList)
         return;
-    _mediaList = mediaList;
+    [_mediaList removeObserver:self forKeyPath:@"media" context:VLCMediaListPlayerContext];
+    [mediaList addObserver:self forKeyPath:@"media" options:0 context:VLCMediaListPlayerContext];
 
-    libvlc_media_list_player_set_media_list(instance, [mediaList libVLCMediaList]);
+    os_unfair_lock_lock(&_shuffleLock);
+    _mediaList = mediaList;
+    _shuffleDeckGeneration = NSNotFound;
+    _shuffleList = _shuffleEnabled ? [[VLCMediaList alloc] init] : nil;
+    _shuffledMedia = nil;
+    VLCMediaList *playedList = _shuffleEnabled ? _shuffleList : mediaList;
+    os_unfair_lock_unlock(&_shuffleLock);
+    [self syncShuffleDeckWithList:mediaList];
+
+    libvlc_media_list_player_set_media_list(instance, [playedList libVLCMediaList]);
+    self.repeatMode = _repeatMode;
     [self willChangeValueForKey:@"rootMedia"];
     _rootMedia = nil;
     [self didChangeValueForKey:@"rootMedia"];
@@ -210,6 +272,9 @@ static void HandleMediaListPlayerStopped(const libvlc_event_t * event, void * op
 
 - (void)playMedia:(VLCMedia *)media
 {
+    if ([self playShuffledMediaPickedByUser:media])
+        return;
+
     dispatch_async(_libVLCBackgroundQueue, ^{
         libvlc_media_list_player_play_item(instance, [media libVLCMediaDescriptor]);
     });
@@ -217,6 +282,15 @@ static void HandleMediaListPlayerStopped(const libvlc_event_t * event, void * op
 
 - (void)play
 {
+    os_unfair_lock_lock(&_shuffleLock);
+    const BOOL nothingPicked = _shuffleEnabled && !_shuffledMedia;
+    os_unfair_lock_unlock(&_shuffleLock);
+    // unless the item playing when shuffle got enabled is paused
+    if (nothingPicked && _mediaPlayer.state != VLCMediaPlayerStatePaused) {
+        [self next];
+        return;
+    }
+
     dispatch_async(_libVLCBackgroundQueue, ^{
         libvlc_media_list_player_play(instance);
     });
@@ -236,16 +310,26 @@ static void HandleMediaListPlayerStopped(const libvlc_event_t * event, void * op
 
 - (BOOL)next
 {
+    BOOL result;
+    if ([self shuffleStep:1 result:&result])
+        return result;
     return libvlc_media_list_player_next(instance) == 0 ? YES : NO;
 }
 
 - (BOOL)previous
 {
+    BOOL result;
+    if ([self shuffleStep:-1 result:&result])
+        return result;
     return libvlc_media_list_player_previous(instance) == 0 ? YES : NO;
 }
 
 - (void)playItemAtNumber:(NSNumber *)index
 {
+    VLCMedia *pickedMedia = [_mediaList mediaAtIndex:[index unsignedIntegerValue]];
+    if (pickedMedia && [self playShuffledMediaPickedByUser:pickedMedia])
+        return;
+
     dispatch_async(_libVLCBackgroundQueue, ^{
         VLCMedia *media = [_mediaList mediaAtIndex:[index intValue]];
         _mediaPlayer.media = media;
@@ -255,10 +339,15 @@ static void HandleMediaListPlayerStopped(const libvlc_event_t * event, void * op
 
 - (void)setRepeatMode:(VLCRepeatMode)repeatMode
 {
+    os_unfair_lock_lock(&_shuffleLock);
+    const BOOL playsShuffleList = _shuffleList != nil;
+    os_unfair_lock_unlock(&_shuffleLock);
+
     libvlc_playback_mode_t mode;
     switch (repeatMode) {
         case VLCRepeatAllItems:
-            mode = libvlc_playback_mode_loop;
+            // the shuffle list must report the end of its only item, the deck starts the next round
+            mode = playsShuffleList ? libvlc_playback_mode_default : libvlc_playback_mode_loop;
             break;
         case VLCDoNotRepeat:
             mode = libvlc_playback_mode_default;
@@ -280,10 +369,356 @@ static void HandleMediaListPlayerStopped(const libvlc_event_t * event, void * op
     return _repeatMode;
 }
 
+#pragma mark - Shuffle
+
+- (BOOL)isShuffleEnabled
+{
+    os_unfair_lock_lock(&_shuffleLock);
+    const BOOL shuffleEnabled = _shuffleEnabled;
+    os_unfair_lock_unlock(&_shuffleLock);
+    return shuffleEnabled;
+}
+
+- (void)setShuffleEnabled:(BOOL)shuffleEnabled
+{
+    // the item playing now counts as the first pick
+    VLCMedia *current = shuffleEnabled ? _mediaPlayer.media : nil;
+    const NSUInteger currentIndex = current ? [_mediaList indexOfMedia:current] : NSNotFound;
+    VLCMediaList *playedList = nil;
+
+    os_unfair_lock_lock(&_shuffleLock);
+    if (_shuffleEnabled == shuffleEnabled) {
+        os_unfair_lock_unlock(&_shuffleLock);
+        return;
+    }
+    _shuffleEnabled = shuffleEnabled;
+    if (shuffleEnabled) {
+        [_shuffleDeck resetWithCount:_shuffleDeck.count];
+        if (currentIndex != NSNotFound)
+            [_shuffleDeck markIndexAsCurrent:currentIndex];
+        if (!_shuffleList) {
+            _shuffleList = [[VLCMediaList alloc] init];
+            playedList = _shuffleList;
+        }
+    } else if (!_shuffledMedia) {
+        _shuffleList = nil;
+        playedList = _mediaList;
+    }
+    // otherwise the shuffled item keeps playing, list order resumes after it
+    os_unfair_lock_unlock(&_shuffleLock);
+
+    if (playedList) {
+        libvlc_media_list_player_set_media_list(instance, [playedList libVLCMediaList]);
+        self.repeatMode = _repeatMode;
+    }
+}
+
+- (NSUInteger)shuffleHistoryLimit
+{
+    os_unfair_lock_lock(&_shuffleLock);
+    const NSUInteger historyLimit = _shuffleDeck.historyLimit;
+    os_unfair_lock_unlock(&_shuffleLock);
+    return historyLimit;
+}
+
+- (void)setShuffleHistoryLimit:(NSUInteger)shuffleHistoryLimit
+{
+    os_unfair_lock_lock(&_shuffleLock);
+    _shuffleDeck.historyLimit = shuffleHistoryLimit;
+    os_unfair_lock_unlock(&_shuffleLock);
+}
+
+/* Moves by offset while shuffling, or back to list order after shuffle got disabled.
+ * Returns NO if the list player should handle the move itself. */
+- (BOOL)shuffleStep:(NSInteger)offset result:(BOOL *)result
+{
+    os_unfair_lock_lock(&_shuffleLock);
+    if (_shuffleEnabled) {
+        VLCMediaList *mediaList = _mediaList;
+        const NSUInteger index = offset > 0 ? [_shuffleDeck nextIndexRepeating:_repeatMode == VLCRepeatAllItems]
+                                            : [_shuffleDeck previousIndex];
+        os_unfair_lock_unlock(&_shuffleLock);
+        // a change of the list meanwhile at worst plays another of its items
+        VLCMedia *media = index != NSNotFound ? [mediaList mediaAtIndex:index] : nil;
+        if (media)
+            [self playShuffledMedia:media];
+        *result = media != nil;
+        return YES;
+    }
+
+    if (_shuffleList) {
+        VLCMedia *current = _shuffledMedia;
+        _shuffleList = nil;
+        _shuffledMedia = nil;
+        os_unfair_lock_unlock(&_shuffleLock);
+        *result = [self resumeListOrderFromMedia:current offset:offset];
+        return YES;
+    }
+
+    os_unfair_lock_unlock(&_shuffleLock);
+    return NO;
+}
+
+- (BOOL)playShuffledMediaPickedByUser:(VLCMedia *)media
+{
+    const NSUInteger index = [_mediaList indexOfMedia:media];
+
+    os_unfair_lock_lock(&_shuffleLock);
+    const BOOL shuffleEnabled = _shuffleEnabled;
+    if (shuffleEnabled && index != NSNotFound)
+        [_shuffleDeck markIndexAsCurrent:index];
+    os_unfair_lock_unlock(&_shuffleLock);
+
+    if (shuffleEnabled)
+        [self playShuffledMedia:media];
+    return shuffleEnabled;
+}
+
+- (void)playShuffledMedia:(VLCMedia *)media
+{
+    // the shuffle list only holds the item being played, so that libvlc reports
+    // its end instead of moving on in list order. Each item gets a list of its
+    // own, the list libvlc is playing is never changed under it.
+    VLCMediaList *shuffleList = [[VLCMediaList alloc] initWithArray:@[media]];
+
+    dispatch_async(_libVLCBackgroundQueue, ^{
+        os_unfair_lock_lock(&_shuffleLock);
+        const BOOL shuffling = _shuffleList != nil;
+        if (shuffling) {
+            _shuffleList = shuffleList;
+            _shuffledMedia = media;
+        }
+        os_unfair_lock_unlock(&_shuffleLock);
+        if (!shuffling)
+            return;
+
+        libvlc_media_list_player_set_media_list(instance, [shuffleList libVLCMediaList]);
+        libvlc_media_list_player_play_item_at_index(instance, 0);
+    });
+}
+
+/* Resets the deck to the items of the list, unless it already follows a later generation */
+- (void)syncShuffleDeckWithList:(nullable VLCMediaList *)mediaList
+{
+    NSUInteger generation = 0;
+    const NSUInteger count = [mediaList mediaCountWithGeneration:&generation];
+
+    os_unfair_lock_lock(&_shuffleLock);
+    if (mediaList == _mediaList && (_shuffleDeckGeneration == NSNotFound || generation > _shuffleDeckGeneration)) {
+        [_shuffleDeck resetWithCount:count];
+        _shuffleDeckGeneration = generation;
+    }
+    os_unfair_lock_unlock(&_shuffleLock);
+}
+
+- (void)observeValueForKeyPath:(NSString *)keyPath
+                      ofObject:(id)object
+                        change:(NSDictionary<NSKeyValueChangeKey,id> *)change
+                       context:(void *)context
+{
+    if (context != VLCMediaListPlayerContext) {
+        [super observeValueForKeyPath:keyPath ofObject:object change:change context:context];
+        return;
+    }
+
+    const NSUInteger generation = [VLCMediaList notifiedMediaGeneration];
+    NSIndexSet *indexes = change[NSKeyValueChangeIndexesKey];
+    const NSKeyValueChange kind = [change[NSKeyValueChangeKindKey] unsignedIntegerValue];
+
+    os_unfair_lock_lock(&_shuffleLock);
+    if (object != _mediaList) {
+        os_unfair_lock_unlock(&_shuffleLock);
+        return;
+    }
+    const BOOL inSync = _shuffleDeckGeneration != NSNotFound && generation != NSNotFound;
+    if (inSync && generation <= _shuffleDeckGeneration) {
+        // already counted when the deck was reset
+        os_unfair_lock_unlock(&_shuffleLock);
+        return;
+    }
+    if (inSync && generation == _shuffleDeckGeneration + 1 && indexes) {
+        // a move is reported as the replacement of the span it touched, its items become unpicked
+        if (kind == NSKeyValueChangeRemoval || kind == NSKeyValueChangeReplacement)
+            [_shuffleDeck removeIndexes:indexes];
+        if (kind == NSKeyValueChangeInsertion || kind == NSKeyValueChangeReplacement)
+            [_shuffleDeck insertIndexes:indexes];
+        _shuffleDeckGeneration = generation;
+        os_unfair_lock_unlock(&_shuffleLock);
+        return;
+    }
+    os_unfair_lock_unlock(&_shuffleLock);
+
+    // a change was missed, notified out of order from another thread
+    [self syncShuffleDeckWithList:object];
+}
+
+- (BOOL)resumeListOrderFromMedia:(nullable VLCMedia *)media offset:(NSInteger)offset
+{
+    VLCMediaList *mediaList = _mediaList;
+    const NSInteger count = mediaList.count;
+    const NSUInteger index = media ? [mediaList indexOfMedia:media] : NSNotFound;
+    NSInteger target = index != NSNotFound ? (NSInteger)index + offset : (offset > 0 ? 0 : -1);
+    if (_repeatMode == VLCRepeatAllItems && count > 0)
+        target = (target % count + count) % count;
+    const BOOL found = target >= 0 && target < count;
+
+    dispatch_async(_libVLCBackgroundQueue, ^{
+        libvlc_media_list_player_set_media_list(instance, [mediaList libVLCMediaList]);
+        self.repeatMode = _repeatMode;
+        if (found)
+            libvlc_media_list_player_play_item_at_index(instance, (int)target);
+    });
+    return found;
+}
+
+#pragma mark - Item transitions
+
+- (NSTimeInterval)lastTransitionGap
+{
+    os_unfair_lock_lock(&_transitionLock);
+    const NSTimeInterval gap = _lastTransitionGap;
+    os_unfair_lock_unlock(&_transitionLock);
+    return gap;
+}
+
+- (NSTimeInterval)averageTransitionGap
+{
+    os_unfair_lock_lock(&_transitionLock);
+    const NSTimeInterval gap = _transitionCount > 0 ? _totalTransitionGap / _transitionCount : 0.;
+    os_unfair_lock_unlock(&_transitionLock);
+    return gap;
+}
+
+- (NSUInteger)transitionCount
+{
+    os_unfair_lock_lock(&_transitionLock);
+    const NSUInteger count = _transitionCount;
+    os_unfair_lock_unlock(&_transitionLock);
+    return count;
+}
+
+- (void)resetTransitionStatistics
+{
+    os_unfair_lock_lock(&_transitionLock);
+    _lastTransitionGap = 0.;
+    _totalTransitionGap = 0.;
+    _transitionCount = 0;
+    os_unfair_lock_unlock(&_transitionLock);
+}
+
+- (void)mediaPlayerStateChanged:(NSNotification *)aNotification
+{
+    const VLCMediaPlayerState state = _mediaPlayer.state;
+    if (state == VLCMediaPlayerStateStopping) {
+        os_unfair_lock_lock(&_transitionLock);
+        if (_itemEndClock == 0)
+            _itemEndClock = libvlc_clock();
+        _preparationTrigger = nil;
+        os_unfair_lock_unlock(&_transitionLock);
+    } else if (state == VLCMediaPlayerStatePlaying) {
+        os_unfair_lock_lock(&_transitionLock);
+        // resuming from pause does not follow a stop
+        if (_itemEndClock > 0) {
+            _lastTransitionGap = (libvlc_clock() - _itemEndClock) / 1000000.;
+            _totalTransitionGap += _lastTransitionGap;
+            _transitionCount++;
+            _itemEndClock = 0;
+        }
+        os_unfair_lock_unlock(&_transitionLock);
+    }
+}
+
+- (void)mediaPlayerTimeChanged:(NSNotification *)aNotification
+{
+    if (!_preparesNextItem)
+        return;
+
+    VLCMedia *media = _mediaPlayer.media;
+    NSNumber *length = media.length.value;
+    NSNumber *time = _mediaPlayer.time.value;
+    if (!length || !time || length.longLongValue - time.longLongValue > _preparationInterval * 1000.)
+        return;
+
+    os_unfair_lock_lock(&_transitionLock);
+    const BOOL alreadyPrepared = _preparationTrigger == media;
+    _preparationTrigger = media;
+    os_unfair_lock_unlock(&_transitionLock);
+    if (alreadyPrepared)
+        return;
+
+    VLCMedia *nextMedia = [self mediaFollowingMedia:media];
+    if (nextMedia)
+        [self prepareMedia:nextMedia];
+}
+
+- (nullable VLCMedia *)mediaFollowingMedia:(VLCMedia *)media
+{
+    // the current input is simply opened again
+    if (_repeatMode == VLCRepeatCurrentItem)
+        return nil;
+
+    os_unfair_lock_lock(&_shuffleLock);
+    if (_shuffleEnabled) {
+        VLCMediaList *mediaList = _mediaList;
+        // drawn ahead, next will pick the same
+        const NSUInteger nextIndex = [_shuffleDeck peekNextIndexRepeating:_repeatMode == VLCRepeatAllItems];
+        os_unfair_lock_unlock(&_shuffleLock);
+        return nextIndex != NSNotFound ? [mediaList mediaAtIndex:nextIndex] : nil;
+    }
+    os_unfair_lock_unlock(&_shuffleLock);
+
+    VLCMediaList *mediaList = _mediaList;
+    const NSUInteger index = [mediaList indexOfMedia:media];
+    if (index == NSNotFound)
+        return nil;
+
+    NSUInteger nextIndex = index + 1;
+    if (nextIndex >= (NSUInteger)mediaList.count) {
+        if (_repeatMode != VLCRepeatAllItems)
+            return nil;
+        nextIndex = 0;
+    }
+    return [mediaList mediaAtIndex:nextIndex];
+}
+
+- (void)prepareMedia:(VLCMedia *)media
+{
+    // the parser reads the metadata of local files, network media are left to the list player alone
+    if (media.parsedStatus == VLCMediaParsedStatusInit)
+        [media parseWithOptions:VLCMediaParseLocal | VLCMediaFetchLocal];
+
+    NSURL *url = media.url;
+    if (!url.isFileURL)
+        return;
+
+    // have the kernel read the ends the demuxers probe first, headers and trailing indexes
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        const int fd = open(url.fileSystemRepresentation, O_RDONLY);
+        if (fd < 0)
+            return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            struct radvisory head = { .ra_offset = 0, .ra_count = (int)MIN(st.st_size, kPrefetchHeadSize) };
+            fcntl(fd, F_RDADVISE, &head);
+            if (st.st_size > kPrefetchHeadSize) {
+                const off_t tailSize = MIN(st.st_size - kPrefetchHeadSize, kPrefetchTailSize);
+                struct radvisory tail = { .ra_offset = st.st_size - tailSize, .ra_count = (int)tailSize };
+                fcntl(fd, F_RDADVISE, &tail);
+            }
+        }
+        close(fd);
+    });
+}
+
 #pragma mark - Delegate methods
 
 - (void)mediaListPlayerPlayed
 {
+    // the shuffled item ended, or shuffle got disabled while it played
+    BOOL result;
+    if ([self shuffleStep:1 result:&result] && result)
+        return;
+
     if ([_delegate respondsToSelector:@selector(mediaListPlayerFinishedPlayback:)]) {
         [_delegate mediaListPlayerFinishedPlayback:self];
     }
@@ -298,6 +733,10 @@ static void HandleMediaListPlayerStopped(const libvlc_event_t * event, void * op
 
 - (void)mediaListPlayerStopped
 {
+    os_unfair_lock_lock(&_transitionLock);
+    _itemEndClock = 0;
+    os_unfair_lock_unlock(&_transitionLock);
+
     if ([_delegate respondsToSelector:@selector(mediaListPlayerStopped:)]) {
         [_delegate mediaListPlayerStopped:self];
     }
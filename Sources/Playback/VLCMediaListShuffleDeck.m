@@ -0,0 +1,263 @@
+/*****************************************************************************
+ * VLCMediaListShuffleDeck.m: VLCKit.framework VLCMediaListShuffleDeck implementation
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#import <VLCMediaListShuffleDeck.h>
+
+#include <stdlib.h>
+
+static NSUInteger RandomIndexBelow(NSUInteger bound)
+{
+    return (NSUInteger)arc4random_uniform((uint32_t)MIN(bound, UINT32_MAX));
+}
+
+@implementation VLCMediaListShuffleDeck
+{
+    NSUInteger *_order;                     ///< Permutation of the indexes, those picked in the round come first
+    NSUInteger *_positions;                 ///< Position of each index in _order
+    NSUInteger _capacity;
+    NSUInteger _dealt;                      ///< Number of indexes picked in the round
+    NSMutableArray<NSNumber *> *_history;   ///< Past picks, followed by the one drawn ahead by peeking
+    NSUInteger _historyPosition;            ///< Position of the current pick in _history, NSNotFound if none
+}
+
+- (instancetype)initWithCount:(NSUInteger)count historyLimit:(NSUInteger)historyLimit
+{
+    if (self = [super init]) {
+        _history = [[NSMutableArray alloc] init];
+        self.historyLimit = historyLimit;
+        [self resetWithCount:count];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    free(_order);
+    free(_positions);
+}
+
+- (void)setHistoryLimit:(NSUInteger)historyLimit
+{
+    _historyLimit = MAX(historyLimit, 2);
+    [self trimHistory];
+}
+
+- (void)resetWithCount:(NSUInteger)count
+{
+    [self reserveCapacity:count];
+    _count = count;
+    for (NSUInteger i = 0; i < count; i++)
+        _order[i] = _positions[i] = i;
+    _dealt = 0;
+    [_history removeAllObjects];
+    _historyPosition = NSNotFound;
+}
+
+- (void)markIndexAsCurrent:(NSUInteger)index
+{
+    if (index >= _count)
+        return;
+
+    [self dealIndex:index];
+    // a pick of the user replaces whatever was drawn ahead
+    const NSUInteger kept = _historyPosition == NSNotFound ? 0 : _historyPosition + 1;
+    [_history removeObjectsInRange:NSMakeRange(kept, _history.count - kept)];
+    [_history addObject:@(index)];
+    _historyPosition = _history.count - 1;
+    [self trimHistory];
+}
+
+- (NSUInteger)nextIndexRepeating:(BOOL)repeat
+{
+    const NSUInteger position = _historyPosition == NSNotFound ? 0 : _historyPosition + 1;
+    if (position < _history.count) {
+        _historyPosition = position;
+        return _history[position].unsignedIntegerValue;
+    }
+
+    const NSUInteger index = [self drawIndexRepeating:repeat];
+    if (index == NSNotFound)
+        return NSNotFound;
+    [_history addObject:@(index)];
+    _historyPosition = _history.count - 1;
+    [self trimHistory];
+    return index;
+}
+
+- (NSUInteger)peekNextIndexRepeating:(BOOL)repeat
+{
+    const NSUInteger position = _historyPosition == NSNotFound ? 0 : _historyPosition + 1;
+    if (position < _history.count)
+        return _history[position].unsignedIntegerValue;
+
+    const NSUInteger index = [self drawIndexRepeating:repeat];
+    if (index == NSNotFound)
+        return NSNotFound;
+    [_history addObject:@(index)];
+    [self trimHistory];
+    return index;
+}
+
+- (NSUInteger)previousIndex
+{
+    if (_historyPosition == NSNotFound || _historyPosition == 0)
+        return NSNotFound;
+
+    _historyPosition--;
+    return _history[_historyPosition].unsignedIntegerValue;
+}
+
+- (void)insertIndexes:(NSIndexSet *)indexes
+{
+    if (indexes.count == 0)
+        return;
+
+    const NSUInteger count = _count + indexes.count;
+    NSUInteger *newIndexes = malloc(MAX(_count, 1) * sizeof(*newIndexes));
+    for (NSUInteger index = 0, oldIndex = 0; index < count; index++) {
+        if (![indexes containsIndex:index])
+            newIndexes[oldIndex++] = index;
+    }
+
+    [self reserveCapacity:count];
+    for (NSUInteger position = 0; position < _count; position++)
+        _order[position] = newIndexes[_order[position]];
+    // the new items join the unpicked ones
+    NSUInteger position = _count;
+    for (NSUInteger index = indexes.firstIndex; index != NSNotFound; index = [indexes indexGreaterThanIndex:index])
+        _order[position++] = index;
+    _count = count;
+    for (position = 0; position < count; position++)
+        _positions[_order[position]] = position;
+
+    for (NSUInteger i = 0; i < _history.count; i++)
+        _history[i] = @(newIndexes[_history[i].unsignedIntegerValue]);
+    free(newIndexes);
+}
+
+- (void)removeIndexes:(NSIndexSet *)indexes
+{
+    if (indexes.count == 0)
+        return;
+    NSAssert(indexes.lastIndex < _count, @"removed indexes out of the list");
+
+    NSUInteger *newIndexes = malloc(MAX(_count, 1) * sizeof(*newIndexes));
+    for (NSUInteger index = 0, newIndex = 0; index < _count; index++)
+        newIndexes[index] = [indexes containsIndex:index] ? NSNotFound : newIndex++;
+
+    // keeps the picked items in front of the unpicked ones
+    NSUInteger kept = 0, dealt = 0;
+    for (NSUInteger position = 0; position < _count; position++) {
+        const NSUInteger index = newIndexes[_order[position]];
+        if (index == NSNotFound)
+            continue;
+        if (position < _dealt)
+            dealt++;
+        _order[kept] = index;
+        _positions[index] = kept;
+        kept++;
+    }
+    _count = kept;
+    _dealt = dealt;
+
+    // the current pick moves back to the last one left before it
+    NSUInteger historyPosition = _historyPosition;
+    for (NSUInteger i = _history.count; i-- > 0;) {
+        const NSUInteger index = newIndexes[_history[i].unsignedIntegerValue];
+        if (index != NSNotFound) {
+            _history[i] = @(index);
+            continue;
+        }
+        [_history removeObjectAtIndex:i];
+        if (historyPosition != NSNotFound && i <= historyPosition)
+            historyPosition = historyPosition > 0 ? historyPosition - 1 : NSNotFound;
+    }
+    _historyPosition = historyPosition;
+    free(newIndexes);
+}
+
+#pragma mark - private
+
+- (void)reserveCapacity:(NSUInteger)capacity
+{
+    if (capacity <= _capacity)
+        return;
+
+    _capacity = MAX(capacity, _capacity * 2);
+    _order = reallocf(_order, _capacity * sizeof(*_order));
+    _positions = reallocf(_positions, _capacity * sizeof(*_positions));
+}
+
+- (void)swapPosition:(NSUInteger)position withPosition:(NSUInteger)otherPosition
+{
+    const NSUInteger index = _order[position];
+    _order[position] = _order[otherPosition];
+    _order[otherPosition] = index;
+    _positions[_order[position]] = position;
+    _positions[index] = otherPosition;
+}
+
+- (void)dealIndex:(NSUInteger)index
+{
+    if (_positions[index] < _dealt)
+        return;
+    [self swapPosition:_positions[index] withPosition:_dealt];
+    _dealt++;
+}
+
+- (NSUInteger)drawIndexRepeating:(BOOL)repeat
+{
+    if (_count == 0)
+        return NSNotFound;
+
+    NSUInteger drawn = _count;
+    if (_dealt == _count) {
+        if (!repeat)
+            return NSNotFound;
+
+        // start a new round, not with the item that ended the previous one if there is a choice
+        _dealt = 0;
+        NSNumber *last = _history.lastObject;
+        if (last && _count > 1) {
+            [self swapPosition:_positions[last.unsignedIntegerValue] withPosition:_count - 1];
+            drawn = _count - 1;
+        }
+    }
+
+    const NSUInteger index = _order[_dealt + RandomIndexBelow(drawn - _dealt)];
+    [self dealIndex:index];
+    return index;
+}
+
+- (void)trimHistory
+{
+    if (_history.count <= _historyLimit)
+        return;
+
+    const NSUInteger excess = _history.count - _historyLimit;
+    [_history removeObjectsInRange:NSMakeRange(0, excess)];
+    if (_historyPosition != NSNotFound)
+        _historyPosition = _historyPosition >= excess ? _historyPosition - excess : NSNotFound;
+}
+
+@end
@@ -36,6 +36,7 @@
 #import <VLCAdjustFilter.h>
 #import <VLCAudioEqualizer.h>
 #import <VLCEventsHandler.h>
+#import <VLCVideoFramePool.h>
 #import <VLCMediaPlayerTitleDescription.h>
 #if !TARGET_OS_IPHONE
 # import <VLCVideoView.h>
@@ -51,6 +52,7 @@
 #endif // !TARGET_OS_IPHONE
 
 #include <vlc/vlc.h>
+#include <os/lock.h>
 
 /* Notification Messages */
 NSNotificationName const VLCMediaPlayerTimeChangedNotification = @"VLCMediaPlayerTimeChangedNotification";
@@ -115,6 +117,8 @@ static IOPMAssertionID displaySleepAssertion = 0;
 - (void)mediaPlayerTitleListChanged:(NSString *)newTitleList;
 
 - (void)mediaPlayerSnapshot:(NSString *)fileName;
+- (void)invalidateTracksCache;
+- (void)retireVideoFramePool;
 @end
 
 @interface VLCMediaPlayer ()
@@ -131,12 +135,16 @@ static IOPMAssertionID displaySleepAssertion = 0;
     dispatch_block_t _onSeekCompletion;
     VLCMediaPlayerState _cachedState;           ///< Cached state of the media being played
     id _drawable;                               ///< The drawable associated to this media player
+    VLCVideoFramePool *_videoFramePool;         ///< Buffers of the video frame handler, if set
     NSMutableArray *_snapshots;                 ///< Array with snapshot file names
     VLCAudio *_audio;                           ///< The audio controller
     libvlc_video_viewpoint_t *_viewpoint;       ///< Current viewpoint of the media
     dispatch_queue_t _libVLCBackgroundQueue;    ///< Background dispatch queue to call libvlc
     int64_t _minimalWatchTimePeriod;            ///< Minimal period for the watch timer
     VLCEventsHandler*       _eventsHandler;     ///< Handles libvlc event callbacks
+    os_unfair_lock _tracksCacheLock;            ///< Protects the track caches below
+    NSUInteger _tracksCacheGeneration;          ///< Bumped on every ES change
+    NSArray<VLCMediaPlayerTrack *> *_tracksCache[3]; ///< Per-type track wrappers (audio, video, text)
 }
 
 /// Timer used to update time watch point interpolation on regular intervals
@@ -271,6 +279,7 @@ static void HandleMediaPlayerTrackChanged(const libvlc_event_t *event, void *opa
         VLCEventsHandler *eventsHandler = (__bridge VLCEventsHandler*)opaque;
         [eventsHandler handleEvent:^(id _Nonnull object) {
             VLCMediaPlayer *mediaPlayer = (VLCMediaPlayer *)object;
+            [mediaPlayer invalidateTracksCache];
             switch (event_type)
             {
                 case libvlc_MediaPlayerESAdded:
@@ -587,10 +596,37 @@ static void HandleMediaPlayerRecord(const libvlc_event_t * event, void * opaque)
     /* Note that ee need the caller to wait until the setter succeeded.
      * Otherwise, s/he might want to deploy the drawable while it isn’t ready yet. */
     dispatch_sync(_libVLCBackgroundQueue, ^{
+        [self retireVideoFramePool];
         libvlc_media_player_set_nsobject(_playerInstance, (__bridge void *)(aDrawable));
     });
 }
 
+- (void)setVideoFrameHandler:(VLCVideoFrameHandler)handler
+                 pixelFormat:(VLCVideoFramePixelFormat)pixelFormat
+                        size:(CGSize)size
+                 bufferCount:(NSUInteger)bufferCount
+                       queue:(dispatch_queue_t)queue
+{
+    VLCVideoFramePool *pool = nil;
+    if (handler)
+        pool = [[VLCVideoFramePool alloc] initWithHandler:handler
+                                              pixelFormat:pixelFormat
+                                                     size:size
+                                              bufferCount:bufferCount
+                                                    queue:queue];
+
+    dispatch_sync(_libVLCBackgroundQueue, ^{
+        [self retireVideoFramePool];
+        if (pool) {
+            _videoFramePool = pool;
+            [pool attachToPlayer:_playerInstance];
+        } else {
+            /* setting the drawable again brings the default video output back */
+            libvlc_media_player_set_nsobject(_playerInstance, (__bridge void *)(_drawable));
+        }
+    });
+}
+
 - (id)drawable
 {
     return (__bridge id)(libvlc_media_player_get_nsobject(_playerInstance));
@@ -1624,6 +1660,7 @@ static const struct event_handler_entry
     [self willChangeValueForKey:@"media"];
     if (_media != newMedia) {
         _media = newMedia;
+        [self invalidateTracksCache];
 
         [self willChangeValueForKey:@"time"];
         [self willChangeValueForKey:@"remainingTime"];
@@ -1665,6 +1702,25 @@ static const struct event_handler_entry
     }
 }
 
+- (void)invalidateTracksCache
+{
+    os_unfair_lock_lock(&_tracksCacheLock);
+    _tracksCacheGeneration++;
+    for (size_t i = 0; i < 3; i++)
+        _tracksCache[i] = nil;
+    os_unfair_lock_unlock(&_tracksCacheLock);
+
+    // the ES list of the media being played is updated alongside ours
+    [_media invalidateTracksCache];
+}
+
+/* called on the libvlc background queue, a video output created before keeps
+ * the pool alive until it is cleaned up, the pool is freed right away otherwise */
+- (void)retireVideoFramePool
+{
+    _videoFramePool = nil;
+}
+
 @end
 
 #pragma mark - VLCMediaPlayer+Tracks
@@ -1758,18 +1814,32 @@ static const struct event_handler_entry
 
 - (NSArray<VLCMediaPlayerTrack *> *)_tracksForType:(const libvlc_track_type_t)type
 {
+    os_unfair_lock_lock(&_tracksCacheLock);
+    NSArray<VLCMediaPlayerTrack *> *tracks = _tracksCache[type];
+    const NSUInteger generation = _tracksCacheGeneration;
+    os_unfair_lock_unlock(&_tracksCacheLock);
+    if (tracks)
+        return tracks;
+
     libvlc_media_tracklist_t *tracklist = libvlc_media_player_get_tracklist(_playerInstance, type, false);
     if (!tracklist)
         return @[];
     
     const size_t tracklistCount = libvlc_media_tracklist_count(tracklist);
-    NSMutableArray<VLCMediaPlayerTrack *> *tracks = [NSMutableArray arrayWithCapacity: (NSUInteger)tracklistCount];
+    NSMutableArray<VLCMediaPlayerTrack *> *fetchedTracks = [NSMutableArray arrayWithCapacity: (NSUInteger)tracklistCount];
     for (size_t i = 0; i < tracklistCount; i++) {
         libvlc_media_track_t *track_t = libvlc_media_tracklist_at(tracklist, i);
         VLCMediaPlayerTrack *track = [[VLCMediaPlayerTrack alloc] initWithMediaTrack: track_t mediaPlayer: self];
-        [tracks addObject: track];
+        [fetchedTracks addObject: track];
     }
     libvlc_media_tracklist_delete(tracklist);
+    tracks = [fetchedTracks copy];
+
+    // selection state is queried live by VLCMediaPlayerTrack, only ES changes invalidate the wrappers
+    os_unfair_lock_lock(&_tracksCacheLock);
+    if (generation == _tracksCacheGeneration && !_tracksCache[type])
+        _tracksCache[type] = tracks;
+    os_unfair_lock_unlock(&_tracksCacheLock);
     return tracks;
 }
 
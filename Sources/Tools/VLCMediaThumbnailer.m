@@ -21,11 +21,25 @@
  *****************************************************************************/
 
 #import <vlc/vlc.h>
+#import <Accelerate/Accelerate.h>
 
 #import <VLCMediaThumbnailer.h>
 #import <VLCLibVLCBridging.h>
 #import <VLCTime.h>
 #import <VLCLibrary.h>
+#import <VLCThumbnailSpriteSheet.h>
+#import <VLCThumbnailDiskCache.h>
+
+/// How a frame of a pixel format is laid out in a single buffer
+typedef struct {
+    unsigned planes;
+    unsigned widths[3];         ///< In pixels
+    unsigned bytesPerPixel[3];
+    unsigned pitches[3];
+    unsigned lines[3];
+    size_t offsets[3];
+    size_t size;
+} VLCThumbnailFrameLayout;
 
 @interface VLCMediaThumbnailer ()
 {
@@ -34,32 +48,224 @@
     void *_mp;
     CGImageRef _thumbnail;
     void *_data;
-    NSTimer *_parsingTimeoutTimer;
-    NSTimer *_thumbnailingTimeoutTimer;
+    dispatch_source_t _parsingTimeoutTimer;
+    dispatch_source_t _thumbnailingTimeoutTimer;
+
+    /* Everything but the frame state below is only touched on _queue.
+     * The video thread owns the frame state while a player is running. */
+    dispatch_queue_t _queue;
+    NSUInteger _session;                ///< Tells late frames of a previous player apart
 
     CGFloat _thumbnailHeight,_thumbnailWidth;
     float _snapshotPosition;
     CGFloat _effectiveThumbnailHeight,_effectiveThumbnailWidth;
-    int _numberOfReceivedFrames;
+    int _numberOfReceivedFrames;        ///< Frame state
+    BOOL _frameCaptured;                ///< Frame state
+    VLCMediaThumbnailerPixelFormat _frameFormat;    ///< Frame state, may differ from the requested one
+    unsigned _frameWidth, _frameHeight; ///< Frame state
+    VLCThumbnailFrameLayout _frameLayout;           ///< Frame state
+
+    NSUInteger _candidateCount;         ///< 0 unless selecting the frame by score
+    NSUInteger _candidateIndex;         ///< Frame state, candidate the next frame is scored as
+    BOOL _candidatesStarted;            ///< Frame state
+    int _candidateFramesSinceSeek;      ///< Frame state
+    long long _candidateLength;         ///< Frame state, 0 when candidates are consecutive frames
+    void *_bestFrame;                   ///< Frame state
+    double _bestScore;                  ///< Frame state
     BOOL _shouldRejectFrames;
 
+    libvlc_media_thumbnail_request_t *_request;
+    libvlc_media_t *_requestMedia;
+    VLCMediaThumbnailer *_requestingSelf; ///< Keeps us alive until the request completed
+
+    NSUInteger _spriteTileCount;        ///< 0 unless fetching a sprite sheet
+    NSUInteger _spriteColumns, _spriteRows;
+    NSUInteger _spriteTileIndex;        ///< Frame state, tile the video thread decodes into
+    int _spriteFramesSinceSeek;         ///< Frame state
+
+    NSString *_diskCacheKey;            ///< Set while fetching a thumbnail missing from the disk cache
+
     VLCLibrary * _library;
 }
 
-- (void)didFetchThumbnail;
-- (void)notifyDelegate;
-- (void)fetchThumbnail;
+- (unsigned)setupFrameWithChroma:(char *)chroma width:(unsigned *)width height:(unsigned *)height pitches:(unsigned *)pitches lines:(unsigned *)lines;
+- (void)lockFrame:(void **)planes;
+- (void)didDisplayFrame;
 - (void)startFetchingThumbnail;
+- (void)didGenerateThumbnail:(libvlc_picture_t *)picture;
+- (void)didParseMedia;
+- (void *)spriteTilePointer;
+- (void)didDisplaySpriteFrame;
 
-@property (readonly, assign, nonatomic) void *dataPointer;
-@property (readonly, assign, nonatomic) BOOL shouldRejectFrames;
+@property (readonly, nonatomic) dispatch_queue_t queue;
 @end
 
+static const char *const kChromas[] = {
+    [VLCMediaThumbnailerPixelFormatRGBA] = "RGBA",
+    [VLCMediaThumbnailerPixelFormatBGRA] = "BGRA",
+    [VLCMediaThumbnailerPixelFormatI420] = "I420",
+    [VLCMediaThumbnailerPixelFormatNV12] = "NV12",
+    [VLCMediaThumbnailerPixelFormatGray] = "GREY",
+};
+
+static VLCThumbnailFrameLayout frameLayout(VLCMediaThumbnailerPixelFormat format, unsigned width, unsigned height)
+{
+    VLCThumbnailFrameLayout layout = { .planes = 1, .widths = { width }, .bytesPerPixel = { 1 }, .lines = { height } };
+    switch (format) {
+        case VLCMediaThumbnailerPixelFormatRGBA:
+        case VLCMediaThumbnailerPixelFormatBGRA:
+            layout.bytesPerPixel[0] = 4;
+            break;
+        case VLCMediaThumbnailerPixelFormatI420:
+            layout.planes = 3;
+            for (unsigned i = 1; i < 3; i++) {
+                layout.widths[i] = (width + 1) / 2;
+                layout.bytesPerPixel[i] = 1;
+                layout.lines[i] = (height + 1) / 2;
+            }
+            break;
+        case VLCMediaThumbnailerPixelFormatNV12:
+            layout.planes = 2;
+            layout.widths[1] = (width + 1) / 2;
+            layout.bytesPerPixel[1] = 2;
+            layout.lines[1] = (height + 1) / 2;
+            break;
+        case VLCMediaThumbnailerPixelFormatGray:
+            break;
+    }
+    for (unsigned i = 0; i < layout.planes; i++) {
+        layout.pitches[i] = layout.widths[i] * layout.bytesPerPixel[i];
+        layout.offsets[i] = layout.size;
+        layout.size += (size_t)layout.pitches[i] * layout.lines[i];
+    }
+    return layout;
+}
+
+/// The format to decode in, when frames of the given chroma can be used without conversion
+static BOOL nativeFrameFormat(const char *chroma, VLCMediaThumbnailerPixelFormat format, VLCMediaThumbnailerPixelFormat *nativeFormat)
+{
+    if (!strncmp(chroma, kChromas[format], 4)) {
+        *nativeFormat = format;
+        return YES;
+    }
+    // the luma plane of YUV comes first, the chroma planes are just ignored
+    if (format != VLCMediaThumbnailerPixelFormatGray)
+        return NO;
+    if (!strncmp(chroma, kChromas[VLCMediaThumbnailerPixelFormatI420], 4)) {
+        *nativeFormat = VLCMediaThumbnailerPixelFormatI420;
+        return YES;
+    }
+    if (!strncmp(chroma, kChromas[VLCMediaThumbnailerPixelFormatNV12], 4)) {
+        *nativeFormat = VLCMediaThumbnailerPixelFormatNV12;
+        return YES;
+    }
+    return NO;
+}
+
+/// Downscales every plane of the destination from the matching plane of the source
+static vImage_Error scaleFrame(void *source, VLCThumbnailFrameLayout from, void *destination, VLCThumbnailFrameLayout to)
+{
+    for (unsigned i = 0; i < to.planes; i++) {
+        const vImage_Buffer src = {
+            .data = (uint8_t *)source + from.offsets[i],
+            .height = from.lines[i],
+            .width = from.widths[i],
+            .rowBytes = from.pitches[i],
+        };
+        const vImage_Buffer dst = {
+            .data = (uint8_t *)destination + to.offsets[i],
+            .height = to.lines[i],
+            .width = to.widths[i],
+            .rowBytes = to.pitches[i],
+        };
+        vImage_Error error;
+        switch (to.bytesPerPixel[i]) {
+            case 4: // the order of the channels does not matter
+                error = vImageScale_ARGB8888(&src, &dst, NULL, kvImageNoFlags);
+                break;
+            case 2:
+                error = vImageScale_CbCr8(&src, &dst, NULL, kvImageNoFlags);
+                break;
+            default:
+                error = vImageScale_Planar8(&src, &dst, NULL, kvImageNoFlags);
+                break;
+        }
+        if (error != kvImageNoError)
+            return error;
+    }
+    return kvImageNoError;
+}
+
+static const double kBlackLevel = 24;
+static const double kWhiteLevel = 235;
+static const double kFlatDeviation = 8;
+
+/// Rates how much a frame shows from the histogram of its luma, 0 for black, washed out and flat frames
+static double frameScore(const void *frame, VLCMediaThumbnailerPixelFormat format, VLCThumbnailFrameLayout layout)
+{
+    // every other row is plenty to tell frames apart
+    vImage_Buffer luma = {
+        .data = (void *)frame,
+        .height = layout.lines[0] / 2,
+        .width = layout.widths[0],
+        .rowBytes = (size_t)layout.pitches[0] * 2,
+    };
+    void *converted = NULL;
+    if (layout.bytesPerPixel[0] == 4) {
+        // BT.601 weights, in the order of the channels in memory
+        static const int16_t rgbaWeights[4] = { 77, 150, 29, 0 };
+        static const int16_t bgraWeights[4] = { 29, 150, 77, 0 };
+        static const int16_t noBias[4] = { 0, 0, 0, 0 };
+        const vImage_Buffer rgb = luma;
+        converted = malloc(luma.width * luma.height);
+        if (!converted)
+            return 0;
+        luma.data = converted;
+        luma.rowBytes = luma.width;
+        if (vImageMatrixMultiply_ARGB8888ToPlanar8(&rgb, &luma,
+                                                   format == VLCMediaThumbnailerPixelFormatBGRA ? bgraWeights : rgbaWeights,
+                                                   256, noBias, 0, kvImageNoFlags) != kvImageNoError) {
+            free(converted);
+            return 0;
+        }
+    }
+
+    vImagePixelCount histogram[256];
+    const vImage_Error error = vImageHistogramCalculation_Planar8(&luma, histogram, kvImageNoFlags);
+    free(converted);
+    const double count = (double)luma.width * luma.height;
+    if (error != kvImageNoError || count == 0)
+        return 0;
+
+    double mean = 0, squares = 0, entropy = 0;
+    for (unsigned i = 0; i < 256; i++) {
+        if (!histogram[i])
+            continue;
+        const double p = histogram[i] / count;
+        mean += p * i;
+        squares += p * i * i;
+        entropy -= p * log2(p);
+    }
+    const double deviation = sqrt(MAX(squares - mean * mean, 0));
+    if (mean < kBlackLevel || mean > kWhiteLevel || deviation < kFlatDeviation)
+        return 0;
+    // detail, weighted by contrast
+    return entropy * deviation;
+}
+
+static unsigned setupFormat(void **opaque, char *chroma,
+                            unsigned *width, unsigned *height,
+                            unsigned *pitches, unsigned *lines)
+{
+    VLCMediaThumbnailer *thumbnailer = (__bridge VLCMediaThumbnailer *)(*opaque);
+    return [thumbnailer setupFrameWithChroma:chroma width:width height:height pitches:pitches lines:lines];
+}
+
 static void *lock(void *opaque, void **pixels)
 {
     VLCMediaThumbnailer *thumbnailer = (__bridge VLCMediaThumbnailer *)(opaque);
 
-    *pixels = [thumbnailer dataPointer];
+    [thumbnailer lockFrame:pixels];
     assert(*pixels);
     return NULL;
 }
@@ -68,6 +274,23 @@ static const size_t kDefaultImageWidth = 320;
 static const size_t kDefaultImageHeight = 240;
 static const float kSnapshotPosition = 0.3;
 static const long long kStandardStartTime = 150000;
+static const NSTimeInterval kSpriteTileTimeout = 1;
+static const NSTimeInterval kParsingTimeout = 10;
+static const NSUInteger kCandidateFrameCount = 5;
+static const double kCandidateSpacing = 0.02;
+static const NSTimeInterval kCandidateFrameTimeout = 1;
+
+static void addThumbnailingOptions(libvlc_media_t *p_md)
+{
+    libvlc_media_add_option(p_md, "no-audio");
+    libvlc_media_add_option(p_md, "no-spu");
+    libvlc_media_add_option(p_md, "avcodec-threads=1");
+    libvlc_media_add_option(p_md, "avcodec-skip-idct=4");
+    libvlc_media_add_option(p_md, "avcodec-skiploopfilter=3");
+    libvlc_media_add_option(p_md, "deinterlace=-1");
+    libvlc_media_add_option(p_md, "avi-index=3");
+    libvlc_media_add_option(p_md, "codec=avcodec,none");
+}
 
 void unlock(void *opaque, void *picture, void *const *p_pixels)
 {
@@ -80,23 +303,74 @@ static void display(void *opaque, void *picture)
     VLCMediaThumbnailer *thumbnailer = (__bridge VLCMediaThumbnailer *)(opaque);
     assert(!picture);
 
-    // We may already have a thumbnail if we are receiving picture after the first one.
-    // Just ignore.
-    if ([thumbnailer thumbnail] || [thumbnailer shouldRejectFrames])
-        return;
+    [thumbnailer didDisplayFrame];
+}
+
+static void *spriteLock(void *opaque, void **pixels)
+{
+    VLCMediaThumbnailer *thumbnailer = (__bridge VLCMediaThumbnailer *)(opaque);
+
+    *pixels = [thumbnailer spriteTilePointer];
+    return NULL;
+}
+
+static void spriteDisplay(void *opaque, void *picture)
+{
+    VLCMediaThumbnailer *thumbnailer = (__bridge VLCMediaThumbnailer *)(opaque);
+    [thumbnailer didDisplaySpriteFrame];
+}
+
+static void thumbnailGenerated(const libvlc_event_t *event, void *opaque)
+{
+    VLCMediaThumbnailer *thumbnailer = (__bridge VLCMediaThumbnailer *)(opaque);
+    libvlc_picture_t *picture = event->u.media_thumbnail_generated.p_thumbnail;
+    if (picture)
+        libvlc_picture_retain(picture);
+
+    dispatch_async(thumbnailer.queue, ^{
+        [thumbnailer didGenerateThumbnail:picture];
+    });
+}
+
+static void mediaParsedChanged(const libvlc_event_t *event, void *opaque)
+{
+    VLCMediaThumbnailer *thumbnailer = (__bridge VLCMediaThumbnailer *)(opaque);
+
+    // not through the media events, those may be delivered on the main thread
+    dispatch_async(thumbnailer.queue, ^{
+        [thumbnailer didParseMedia];
+    });
+}
+
+static void releasePicture(void *info, const void *data, size_t size)
+{
+    libvlc_picture_release((libvlc_picture_t *)info);
+}
+
+static void releaseThumbnailData(void *info, const void *data, size_t size)
+{
+    CFRelease(info);
+}
 
-    [thumbnailer performSelectorOnMainThread:@selector(didFetchThumbnail) withObject:nil waitUntilDone:YES];
+static dispatch_source_t createTimeoutTimer(dispatch_queue_t queue, NSTimeInterval interval, dispatch_block_t handler)
+{
+    dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, queue);
+    dispatch_source_set_timer(timer,
+                              dispatch_time(DISPATCH_TIME_NOW, (int64_t)(interval * NSEC_PER_SEC)),
+                              DISPATCH_TIME_FOREVER,
+                              100 * NSEC_PER_MSEC);
+    dispatch_source_set_event_handler(timer, handler);
+    dispatch_resume(timer);
+    return timer;
 }
 
 @implementation VLCMediaThumbnailer
 @synthesize media=_media;
 @synthesize delegate=_thumbnailingDelegate;
 @synthesize thumbnail=_thumbnail;
-@synthesize dataPointer=_data;
 @synthesize thumbnailWidth=_thumbnailWidth;
 @synthesize thumbnailHeight=_thumbnailHeight;
 @synthesize snapshotPosition=_snapshotPosition;
-@synthesize shouldRejectFrames=_shouldRejectFrames;
 
 + (VLCMediaThumbnailer *)thumbnailerWithMedia:(VLCMedia *)media andDelegate:(id<VLCMediaThumbnailerDelegate>)delegate
 {
@@ -119,12 +393,23 @@ static void display(void *opaque, void *picture)
     return obj;
 }
 
+- (instancetype)init
+{
+    if (self = [super init]) {
+        dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0);
+        _queue = dispatch_queue_create("org.videolan.VLCMediaThumbnailer", attr);
+        _candidateFrameCount = kCandidateFrameCount;
+    }
+    return self;
+}
+
 - (void)dealloc
 {
     NSAssert(!_thumbnailingTimeoutTimer, @"Timer not released");
     NSAssert(!_parsingTimeoutTimer, @"Timer not released");
     NSAssert(!_data, @"Data not released");
     NSAssert(!_mp, @"Not properly retained");
+    NSAssert(!_request, @"Request not released");
     if (_thumbnail)
         CGImageRelease(_thumbnail);
 }
@@ -134,16 +419,123 @@ static void display(void *opaque, void *picture)
     _library = library;
 }
 
+- (dispatch_queue_t)queue
+{
+    return _queue;
+}
+
+#pragma mark - delegate
+
+- (void)notifyDelegateOfThumbnail
+{
+    id<VLCMediaThumbnailerDelegate> delegate = _thumbnailingDelegate;
+    CGImageRef thumbnail = CGImageRetain(_thumbnail);
+    dispatch_async(_delegateQueue ?: dispatch_get_main_queue(), ^{
+        [delegate mediaThumbnailer:self didFinishThumbnail:thumbnail];
+        CGImageRelease(thumbnail);
+    });
+}
+
+- (void)notifyDelegateOfTimeOut
+{
+    id<VLCMediaThumbnailerDelegate> delegate = _thumbnailingDelegate;
+    dispatch_async(_delegateQueue ?: dispatch_get_main_queue(), ^{
+        [delegate mediaThumbnailerDidTimeOut:self];
+    });
+}
+
+- (void)notifyDelegateOfSpriteSheet:(VLCThumbnailSpriteSheet *)spriteSheet
+{
+    id<VLCMediaThumbnailerDelegate> delegate = _thumbnailingDelegate;
+    if (![delegate respondsToSelector:@selector(mediaThumbnailer:didFinishSpriteSheet:)])
+        return;
+    dispatch_async(_delegateQueue ?: dispatch_get_main_queue(), ^{
+        [delegate mediaThumbnailer:self didFinishSpriteSheet:spriteSheet];
+    });
+}
+
+#pragma mark - fetching
+
 - (void)fetchThumbnail
 {
-    NSAssert(!_data, @"We are already fetching a thumbnail");
+    dispatch_async(_queue, ^{
+        [self lookUpThumbnail];
+    });
+}
+
+- (void)lookUpThumbnail
+{
+    _spriteTileCount = 0;
+    _diskCacheKey = nil;
+    _thumbnailData = nil;
+
+    // neither a snapshot time, the pixel format nor the frame selection is part of the cache key
+    VLCThumbnailDiskCache *diskCache = _diskCache;
+    if (!diskCache ||
+        (_mode == VLCMediaThumbnailerModeThumbnailRequest && _snapshotTime) ||
+        (_mode == VLCMediaThumbnailerModePlayback && _pixelFormat != VLCMediaThumbnailerPixelFormatRGBA) ||
+        (_mode == VLCMediaThumbnailerModePlayback && _frameSelection != VLCMediaThumbnailerFrameSelectionPosition)) {
+        [self parseMediaAndStartFetching];
+        return;
+    }
 
+    const CGSize size = CGSizeMake(_thumbnailWidth > 0 ? _thumbnailWidth : kDefaultImageWidth,
+                                   _thumbnailHeight > 0 ? _thumbnailHeight : kDefaultImageHeight);
+    const float position = _snapshotPosition > 0 ? _snapshotPosition : kSnapshotPosition;
+    // fingerprinting reads the file, our queue can afford it
+    NSString *key = [diskCache keyForMedia:_media size:size position:position];
+    CGImageRef thumbnail = key ? [diskCache copyImageForKey:key] : NULL;
+    if (!thumbnail) {
+        _diskCacheKey = key;
+        [self parseMediaAndStartFetching];
+        return;
+    }
+
+    // no player involved at all
+    if (_thumbnail)
+        CGImageRelease(_thumbnail);
+    _thumbnail = thumbnail;
+    _thumbnailWidth = CGImageGetWidth(thumbnail);
+    _thumbnailHeight = CGImageGetHeight(thumbnail);
+    [self notifyDelegateOfThumbnail];
+}
+
+- (void)storeThumbnailInDiskCache
+{
+    if (_diskCacheKey && _thumbnail)
+        [_diskCache storeImage:_thumbnail forKey:_diskCacheKey];
+    _diskCacheKey = nil;
+}
+
+- (void)fetchSpriteSheetWithTileCount:(NSUInteger)tileCount columns:(NSUInteger)columns rows:(NSUInteger)rows
+{
+    NSAssert(tileCount > 0, @"A sprite sheet needs tiles");
+    dispatch_async(_queue, ^{
+        self->_spriteTileCount = tileCount;
+        self->_diskCacheKey = nil;
+        self->_spriteColumns = columns;
+        self->_spriteRows = rows;
+        [self parseMediaAndStartFetching];
+    });
+}
+
+- (void)parseMediaAndStartFetching
+{
+    NSAssert(!_mp && !_data && !_request, @"We are already fetching a thumbnail");
+
+    // the thumbnail request opens the media itself, the size then follows its aspect ratio
     VLCMediaParsedStatus parsedStatus = [_media parsedStatus];
-    if (!(parsedStatus == VLCMediaParsedStatusFailed || parsedStatus == VLCMediaParsedStatusDone)) {
-        [_media addObserver:self forKeyPath:@"parsedStatus" options:0 context:NULL];
-        [_media parseWithOptions:VLCMediaParseLocal | VLCMediaParseNetwork];
+    if ((_mode == VLCMediaThumbnailerModePlayback || _spriteTileCount > 0) &&
+        !(parsedStatus == VLCMediaParsedStatusFailed || parsedStatus == VLCMediaParsedStatusDone)) {
         NSAssert(!_parsingTimeoutTimer, @"We already have a timer around");
-        _parsingTimeoutTimer = [NSTimer scheduledTimerWithTimeInterval:10 target:self selector:@selector(mediaParsingTimedOut) userInfo:nil repeats:NO];
+        _parsingTimeoutTimer = createTimeoutTimer(_queue, kParsingTimeout, ^{
+            [self mediaParsingTimedOut];
+        });
+        libvlc_event_attach(libvlc_media_event_manager([_media libVLCMediaDescriptor]),
+                            libvlc_MediaParsedChanged,
+                            mediaParsedChanged,
+                            (__bridge void *)(self));
+        [_media parseWithOptions:VLCMediaParseLocal | VLCMediaParseNetwork];
         return;
     }
 
@@ -176,97 +568,369 @@ static void display(void *opaque, void *picture)
         imageHeight = newHeight > 0 ? newHeight : imageHeight;
     }
 
+    // no player exists, the frame state is ours until the next one starts
+    _session++;
     _numberOfReceivedFrames = 0;
-    NSAssert(!_shouldRejectFrames, @"Are we still running?");
+    _frameCaptured = NO;
+    _shouldRejectFrames = NO;
+    _candidateCount = _frameSelection == VLCMediaThumbnailerFrameSelectionScore ? MAX(_candidateFrameCount, 1) : 0;
+    _candidateIndex = 0;
+    _candidatesStarted = NO;
+    _candidateFramesSinceSeek = 0;
+    _bestScore = -1;
 
     _effectiveThumbnailHeight = imageHeight;
     _effectiveThumbnailWidth = imageWidth;
     _snapshotPosition = snapshotPosition;
 
-    _data = calloc(1, imageWidth * imageHeight * 4);
-    NSAssert(_data, @"Can't create data");
+    if (_spriteTileCount > 0) {
+        [self startFetchingSpriteSheetWithTileWidth:imageWidth height:imageHeight];
+        return;
+    }
+
+    if (_mode == VLCMediaThumbnailerModeThumbnailRequest) {
+        [self startThumbnailRequestWithWidth:videoTrack ? imageWidth : 0 height:imageHeight];
+        return;
+    }
 
     NSAssert(!_mp, @"We are already fetching a thumbnail");
-    _mp = libvlc_media_player_new(_library.instance);
+    // our own copy sharing the parsed state, so that our options do not
+    // stay on the media and slow down its regular playback
+    libvlc_media_t *p_md = libvlc_media_duplicate([_media libVLCMediaDescriptor]);
+    _mp = p_md ? libvlc_media_player_new(_library.instance) : NULL;
     if (_mp == NULL) {
         NSAssert(0, @"%s: creating the player instance failed", __PRETTY_FUNCTION__);
-        [self endThumbnailing];
+        if (p_md)
+            libvlc_media_release(p_md);
+        [self mediaThumbnailingTimedOut];
+        return;
     }
 
-    libvlc_media_add_option([_media libVLCMediaDescriptor], "no-audio");
-    libvlc_media_add_option([_media libVLCMediaDescriptor], "no-spu");
-    libvlc_media_add_option([_media libVLCMediaDescriptor], "avcodec-threads=1");
-    libvlc_media_add_option([_media libVLCMediaDescriptor], "avcodec-skip-idct=4");
-    libvlc_media_add_option([_media libVLCMediaDescriptor], "avcodec-skiploopfilter=3");
-    libvlc_media_add_option([_media libVLCMediaDescriptor], "deinterlace=-1");
-    libvlc_media_add_option([_media libVLCMediaDescriptor], "avi-index=3");
-    libvlc_media_add_option([_media libVLCMediaDescriptor], "codec=avcodec,none");
-
-    libvlc_media_player_set_media(_mp, [_media libVLCMediaDescriptor]);
-    libvlc_video_set_format(_mp, "RGBA", imageWidth, imageHeight, 4 * imageWidth);
-    libvlc_video_set_callbacks(_mp, lock, unlock, display, (__bridge void *)(self));
+    addThumbnailingOptions(p_md);
     if (snapshotPosition == kSnapshotPosition) {
         int length = _media.length.intValue;
         if (length < kStandardStartTime) {
             VKLog(@"short file detected");
             if (length > 1000) {
                 VKLog(@"attempting seek to %is", (length * 25 / 100000));
-                libvlc_media_add_option([_media libVLCMediaDescriptor], [[NSString stringWithFormat:@"start-time=%i", (length * 25 / 100000)] UTF8String]);
+                libvlc_media_add_option(p_md, [[NSString stringWithFormat:@"start-time=%i", (length * 25 / 100000)] UTF8String]);
             }
         } else
-            libvlc_media_add_option([_media libVLCMediaDescriptor], [[NSString stringWithFormat:@"start-time=%lli", (kStandardStartTime / 1000)] UTF8String]);
+            libvlc_media_add_option(p_md, [[NSString stringWithFormat:@"start-time=%lli", (kStandardStartTime / 1000)] UTF8String]);
+    }
+
+    libvlc_media_player_set_media(_mp, p_md);
+    libvlc_media_release(p_md);
+    libvlc_video_set_format_callbacks(_mp, setupFormat, NULL);
+    libvlc_video_set_callbacks(_mp, lock, unlock, display, (__bridge void *)(self));
+    libvlc_media_player_play(_mp);
+
+    // every candidate is sought to, give it some time
+    [self startThumbnailingTimeoutTimer:[self thumbnailingTimeout] + _candidateCount * kCandidateFrameTimeout];
+}
+
+- (void)startThumbnailingTimeoutTimer:(NSTimeInterval)timeout
+{
+    NSAssert(!_thumbnailingTimeoutTimer, @"We already have a timer around");
+    // retains us like a run loop timer would, until it is cancelled
+    _thumbnailingTimeoutTimer = createTimeoutTimer(_queue, timeout, ^{
+        [self mediaThumbnailingTimedOut];
+    });
+}
+
+- (void)cancelThumbnailingTimeoutTimer
+{
+    if (_thumbnailingTimeoutTimer)
+        dispatch_source_cancel(_thumbnailingTimeoutTimer);
+    _thumbnailingTimeoutTimer = nil;
+}
+
+- (void)startFetchingSpriteSheetWithTileWidth:(unsigned)tileWidth height:(unsigned)tileHeight
+{
+    _spriteSheet = [[VLCThumbnailSpriteSheet alloc] initWithTileCount:_spriteTileCount
+                                                              columns:_spriteColumns
+                                                                 rows:_spriteRows
+                                                            tileWidth:tileWidth
+                                                           tileHeight:tileHeight
+                                                             duration:_media.length.value.longLongValue];
+    _spriteTileIndex = 0;
+    _spriteFramesSinceSeek = 0;
+
+    // our own copy, so that the start time does not stay on the media
+    libvlc_media_t *p_md = _spriteSheet ? libvlc_media_duplicate([_media libVLCMediaDescriptor]) : NULL;
+    _mp = p_md ? libvlc_media_player_new(_library.instance) : NULL;
+    if (!_mp) {
+        if (p_md)
+            libvlc_media_release(p_md);
+        _spriteSheet = nil;
+        [self mediaThumbnailingTimedOut];
+        return;
     }
+
+    addThumbnailingOptions(p_md);
+    libvlc_media_add_option(p_md, [[NSString stringWithFormat:@"start-time=%.3f", [_spriteSheet timeOfTileAtIndex:0] / 1000.] UTF8String]);
+    libvlc_media_player_set_media(_mp, p_md);
+    libvlc_media_release(p_md);
+
+    // every tile is decoded in place, at its offset in the shared buffer of the sheet
+    libvlc_video_set_format(_mp, "RGBA", tileWidth, tileHeight, (unsigned)_spriteSheet.pitch);
+    libvlc_video_set_callbacks(_mp, spriteLock, unlock, spriteDisplay, (__bridge void *)(self));
     libvlc_media_player_play(_mp);
 
+    // the whole media is sought through, give every tile some time
+    [self startThumbnailingTimeoutTimer:[self thumbnailingTimeout] + _spriteTileCount * kSpriteTileTimeout];
+}
+
+- (void *)spriteTilePointer
+{
+    // once done, late pictures go to the scratch area of the sheet
+    return [_spriteSheet pixelsOfTileAtIndex:_shouldRejectFrames ? NSNotFound : _spriteTileIndex];
+}
+
+- (void)didDisplaySpriteFrame
+{
+    if (_shouldRejectFrames || _spriteTileIndex >= _spriteTileCount)
+        return;
+
+    // the first picture after a seek may still be from before it
+    if (++_spriteFramesSinceSeek < 2)
+        return;
+
+    _spriteFramesSinceSeek = 0;
+    if (++_spriteTileIndex == _spriteTileCount) {
+        const NSUInteger session = _session;
+        dispatch_async(_queue, ^{
+            if (session == self->_session)
+                [self didFetchSpriteSheet];
+        });
+        return;
+    }
+
+    // keyframes are close enough for a tile and much cheaper to reach
+    libvlc_media_player_set_time(_mp, [_spriteSheet timeOfTileAtIndex:_spriteTileIndex], true);
+}
+
+- (void)didFetchSpriteSheet
+{
+    if (_shouldRejectFrames)
+        return;
+
+    [self endThumbnailing];
+
+    // after a time-out the video thread may still write tiles, until the
+    // player is released and endThumbnailing lets our queue go again
+    VLCThumbnailSpriteSheet *spriteSheet = _spriteSheet;
+    dispatch_async(_queue, ^{
+        [spriteSheet createImages];
+        [self notifyDelegateOfSpriteSheet:spriteSheet];
+    });
+}
+
+- (NSTimeInterval)thumbnailingTimeout
+{
     NSURL *url = _media.url;
-    NSTimeInterval timeoutDuration = 10;
     if (![url.scheme isEqualToString:@"file"]) {
         VKLog(@"media is remote, will wait longer");
-        timeoutDuration = 45;
+        return 45;
     }
+    return 10;
+}
 
-    NSAssert(!_thumbnailingTimeoutTimer, @"We already have a timer around");
-    _thumbnailingTimeoutTimer = [NSTimer scheduledTimerWithTimeInterval:timeoutDuration target:self selector:@selector(mediaThumbnailingTimedOut) userInfo:nil repeats:NO];
+- (void)startThumbnailRequestWithWidth:(unsigned)width height:(unsigned)height
+{
+    // our own copy, so that its events only report our request
+    _requestMedia = libvlc_media_duplicate([_media libVLCMediaDescriptor]);
+    if (!_requestMedia) {
+        [self mediaThumbnailingTimedOut];
+        return;
+    }
+    libvlc_event_attach(libvlc_media_event_manager(_requestMedia),
+                        libvlc_MediaThumbnailGenerated,
+                        thumbnailGenerated,
+                        (__bridge void *)(self));
+
+    const libvlc_time_t timeout = (libvlc_time_t)([self thumbnailingTimeout] * 1000);
+    NSNumber *snapshotTime = _snapshotTime.value;
+    if (snapshotTime)
+        _request = libvlc_media_thumbnail_request_by_time(_library.instance, _requestMedia,
+                                                          snapshotTime.longLongValue,
+                                                          libvlc_media_thumbnail_seek_fast,
+                                                          width, height, false,
+                                                          libvlc_picture_Argb, timeout);
+    else
+        _request = libvlc_media_thumbnail_request_by_pos(_library.instance, _requestMedia,
+                                                         _snapshotPosition,
+                                                         libvlc_media_thumbnail_seek_fast,
+                                                         width, height, false,
+                                                         libvlc_picture_Argb, timeout);
+    if (!_request) {
+        [self endThumbnailRequest];
+        [self mediaThumbnailingTimedOut];
+        return;
+    }
+    _requestingSelf = self;
+}
+
+- (void)endThumbnailRequest
+{
+    if (_request)
+        libvlc_media_thumbnail_request_destroy(_request);
+    _request = NULL;
+    if (_requestMedia) {
+        libvlc_event_detach(libvlc_media_event_manager(_requestMedia),
+                            libvlc_MediaThumbnailGenerated,
+                            thumbnailGenerated,
+                            (__bridge void *)(self));
+        libvlc_media_release(_requestMedia);
+    }
+    _requestMedia = NULL;
+}
+
+- (void)didGenerateThumbnail:(libvlc_picture_t *)picture
+{
+    if (!_request) {
+        if (picture)
+            libvlc_picture_release(picture);
+        return;
+    }
+    [self endThumbnailRequest];
+    // the block that called us retains us until we return
+    _requestingSelf = nil;
+
+    if (!picture) {
+        VKLog(@"WARNING: media thumbnailer thumbnail request failed or timed out");
+        [self notifyDelegateOfTimeOut];
+        return;
+    }
+
+    // the image reads the picture buffer of libvlc, no copy is made
+    size_t size;
+    const unsigned char *buffer = libvlc_picture_get_buffer(picture, &size);
+    const unsigned width = libvlc_picture_get_width(picture);
+    const unsigned height = libvlc_picture_get_height(picture);
+    CGDataProviderRef provider = CGDataProviderCreateWithData(picture, buffer, size, releasePicture);
+    if (!provider) {
+        libvlc_picture_release(picture);
+        [self notifyDelegateOfTimeOut];
+        return;
+    }
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+    CGImageRef thumbnail = CGImageCreate(width,
+                                         height,
+                                         8,
+                                         32,
+                                         libvlc_picture_get_stride(picture),
+                                         colorSpace,
+                                         (CGBitmapInfo)kCGImageAlphaNoneSkipFirst,
+                                         provider,
+                                         NULL,
+                                         false,
+                                         kCGRenderingIntentDefault);
+    CGColorSpaceRelease(colorSpace);
+    CGDataProviderRelease(provider);
+
+    if (_thumbnail)
+        CGImageRelease(_thumbnail);
+    _thumbnail = thumbnail;
+    _thumbnailWidth = width;
+    _thumbnailHeight = height;
+    [self storeThumbnailInDiskCache];
+
+    [self notifyDelegateOfThumbnail];
 }
 
 - (void)mediaParsingTimedOut
 {
     VKLog(@"WARNING: media thumbnailer media parsing timed out");
-    [_media removeObserver:self forKeyPath:@"parsedStatus"];
+    [self didParseMedia];
+}
+
+- (void)didParseMedia
+{
+    // the timer is gone once either the parsing or its time-out was handled
+    if (!_parsingTimeoutTimer)
+        return;
+    dispatch_source_cancel(_parsingTimeoutTimer);
+    _parsingTimeoutTimer = nil;
+    libvlc_event_detach(libvlc_media_event_manager([_media libVLCMediaDescriptor]),
+                        libvlc_MediaParsedChanged,
+                        mediaParsedChanged,
+                        (__bridge void *)(self));
 
     [self startFetchingThumbnail];
 }
 
-- (void)observeValueForKeyPath:(NSString *)keyPath ofObject:(id)object change:(NSDictionary *)change context:(void *)context
+- (unsigned)setupFrameWithChroma:(char *)chroma width:(unsigned *)width height:(unsigned *)height pitches:(unsigned *)pitches lines:(unsigned *)lines
 {
-    if (object == _media && [keyPath isEqualToString:@"parsedStatus"]) {
-        [_parsingTimeoutTimer invalidate];
-        _parsingTimeoutTimer = nil;
-        [_media removeObserver:self forKeyPath:@"parsedStatus"];
-        [self startFetchingThumbnail];
+    VLCMediaThumbnailerPixelFormat format = _pixelFormat;
+    unsigned frameWidth = _effectiveThumbnailWidth;
+    unsigned frameHeight = _effectiveThumbnailHeight;
 
-        return;
+    // The video output would scale every frame. When the decoder already
+    // produces our format, take its frames as they are and only scale the
+    // one we keep.
+    VLCMediaThumbnailerPixelFormat nativeFormat;
+    if ((*width > frameWidth || *height > frameHeight) && nativeFrameFormat(chroma, format, &nativeFormat)) {
+        format = nativeFormat;
+        frameWidth = *width;
+        frameHeight = *height;
+    }
+
+    const VLCThumbnailFrameLayout layout = frameLayout(format, frameWidth, frameHeight);
+    void *data = malloc(layout.size);
+    if (!data)
+        return 0;
+    // called again on format changes, the previous frames are of no use then
+    free(_data);
+    _data = data;
+    free(_bestFrame);
+    _bestFrame = NULL;
+    _bestScore = -1;
+    _frameFormat = format;
+    _frameWidth = frameWidth;
+    _frameHeight = frameHeight;
+    _frameLayout = layout;
+
+    memcpy(chroma, kChromas[format], 4);
+    *width = frameWidth;
+    *height = frameHeight;
+    for (unsigned i = 0; i < layout.planes; i++) {
+        pitches[i] = layout.pitches[i];
+        lines[i] = layout.lines[i];
     }
-    return [super observeValueForKeyPath:keyPath ofObject:object change:change context:context];
+    return 1;
 }
 
-- (void)didFetchThumbnail
+- (void)lockFrame:(void **)planes
 {
-    if (_shouldRejectFrames)
+    for (unsigned i = 0; i < _frameLayout.planes; i++)
+        planes[i] = (uint8_t *)_data + _frameLayout.offsets[i];
+}
+
+- (void)didDisplayFrame
+{
+    // We may already have a thumbnail if we are receiving picture after the first one.
+    // Just ignore.
+    if (_frameCaptured || _shouldRejectFrames)
+        return;
+
+    if (_candidateCount > 0) {
+        [self didDisplayCandidateFrame];
         return;
+    }
 
-    // The video thread is blocking on us. Beware not to do too much work.
+    // Runs on the video thread, which waits for nobody but us.
     _numberOfReceivedFrames++;
 
     float position = libvlc_media_player_get_position(_mp);
     long long length = libvlc_media_player_get_length(_mp);
 
     // Make sure we are getting the right frame
-    if (position < self.snapshotPosition && _numberOfReceivedFrames < 2) {
-        libvlc_media_player_set_position(_mp, self.snapshotPosition, YES);
+    if (position < _snapshotPosition && _numberOfReceivedFrames < 2) {
+        libvlc_media_player_set_position(_mp, _snapshotPosition, YES);
         return;
     }
-    if ((length < kStandardStartTime * 2 && _numberOfReceivedFrames < 5) && self.snapshotPosition == kSnapshotPosition) {
+    if ((length < kStandardStartTime * 2 && _numberOfReceivedFrames < 5) && _snapshotPosition == kSnapshotPosition) {
         libvlc_media_player_set_position(_mp, kSnapshotPosition, YES);
         return;
     }
@@ -280,35 +944,144 @@ static void display(void *opaque, void *picture)
         return;
     }
 
-    NSAssert(_data, @"We have no data");
-    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
-    const CGFloat width = _effectiveThumbnailWidth;
-    const CGFloat height = _effectiveThumbnailHeight;
-    const CGFloat pitch = 4 * width;
-    CGContextRef bitmap = CGBitmapContextCreate(_data,
-                                                width,
-                                                height,
-                                                8,
-                                                pitch,
-                                                colorSpace,
-                                                kCGImageAlphaNoneSkipLast);
+    // Hand the frame over as is and give late pictures a new buffer,
+    // lock and display both run on this thread.
+    void *frame = _data;
+    void *spare = malloc(_frameLayout.size);
+    if (!spare)
+        return;
+    _data = spare;
+    [self handOverFrame:frame];
+}
 
+- (void)didDisplayCandidateFrame
+{
+    // the first picture after a seek may still be from before it
+    if (++_candidateFramesSinceSeek < 2)
+        return;
+
+    if (!_candidatesStarted) {
+        _candidatesStarted = YES;
+        // without a length there is nothing to seek to, take the next frames
+        _candidateLength = libvlc_media_player_get_length(_mp);
+        if (_candidateLength > 0) {
+            [self seekToCandidate];
+            return;
+        }
+    }
+
+    const double score = frameScore(_data, _frameFormat, _frameLayout);
+    if (score > _bestScore) {
+        // keep the frame, the next ones go to the buffer of the previous best
+        void *frame = _bestFrame ?: malloc(_frameLayout.size);
+        if (!frame)
+            return;
+        _bestFrame = _data;
+        _data = frame;
+        _bestScore = score;
+    }
+
+    if (++_candidateIndex < _candidateCount) {
+        if (_candidateLength > 0)
+            [self seekToCandidate];
+        return;
+    }
+
+    void *frame = _bestFrame;
+    _bestFrame = NULL;
+    [self handOverFrame:frame];
+}
+
+- (void)seekToCandidate
+{
+    // centered on the snapshot position, keyframes are close enough
+    const double offset = ((double)_candidateIndex - (_candidateCount - 1) / 2.) * kCandidateSpacing;
+    const double position = MIN(MAX(_snapshotPosition + offset, 0.), 1.);
+    const long long time = MIN((long long)(position * _candidateLength), MAX(_candidateLength - 1000, 0));
+    _candidateFramesSinceSeek = 0;
+    libvlc_media_player_set_time(_mp, time, true);
+}
+
+- (void)handOverFrame:(void *)frame
+{
+    _frameCaptured = YES;
+
+    const NSUInteger session = _session;
+    const VLCMediaThumbnailerPixelFormat format = _frameFormat;
+    const unsigned width = _frameWidth;
+    const unsigned height = _frameHeight;
+    dispatch_async(_queue, ^{
+        if (session != self->_session || self->_shouldRejectFrames) {
+            free(frame);
+            return;
+        }
+        [self didFetchThumbnail:frame format:format width:width height:height];
+    });
+}
+
+- (void)didFetchThumbnail:(void *)frame format:(VLCMediaThumbnailerPixelFormat)frameFormat width:(unsigned)frameWidth height:(unsigned)frameHeight
+{
+    const VLCMediaThumbnailerPixelFormat format = _pixelFormat;
+    const unsigned width = _effectiveThumbnailWidth;
+    const unsigned height = _effectiveThumbnailHeight;
+    const VLCThumbnailFrameLayout layout = frameLayout(format, width, height);
+
+    // a native frame skipped the scaler of the video output
+    if (frameFormat != format || frameWidth != width || frameHeight != height) {
+        void *scaled = malloc(layout.size);
+        if (!scaled || scaleFrame(frame, frameLayout(frameFormat, frameWidth, frameHeight), scaled, layout) != kvImageNoError) {
+            free(scaled);
+            free(frame);
+            [self mediaThumbnailingTimedOut];
+            return;
+        }
+        free(frame);
+        frame = scaled;
+    }
+
+    // the data and the image own the frame from now on, no copy is made
+    NSData *data = [[NSData alloc] initWithBytesNoCopy:frame length:layout.size freeWhenDone:YES];
+    const BOOL isRGB = format == VLCMediaThumbnailerPixelFormatRGBA || format == VLCMediaThumbnailerPixelFormatBGRA;
+    CGDataProviderRef provider = CGDataProviderCreateWithData((void *)CFBridgingRetain(data),
+                                                              data.bytes,
+                                                              (size_t)layout.pitches[0] * layout.lines[0],
+                                                              releaseThumbnailData);
+    if (!provider) {
+        CFRelease((__bridge CFTypeRef)data);
+        [self mediaThumbnailingTimedOut];
+        return;
+    }
+    CGBitmapInfo bitmapInfo = (CGBitmapInfo)kCGImageAlphaNone;
+    if (format == VLCMediaThumbnailerPixelFormatRGBA)
+        bitmapInfo = (CGBitmapInfo)kCGImageAlphaNoneSkipLast;
+    else if (format == VLCMediaThumbnailerPixelFormatBGRA)
+        bitmapInfo = kCGBitmapByteOrder32Little | (CGBitmapInfo)kCGImageAlphaNoneSkipFirst;
+    CGColorSpaceRef colorSpace = isRGB ? CGColorSpaceCreateDeviceRGB() : CGColorSpaceCreateDeviceGray();
+    CGImageRef thumbnail = CGImageCreate(width,
+                                         height,
+                                         8,
+                                         isRGB ? 32 : 8,
+                                         layout.pitches[0],
+                                         colorSpace,
+                                         bitmapInfo,
+                                         provider,
+                                         NULL,
+                                         false,
+                                         kCGRenderingIntentDefault);
     CGColorSpaceRelease(colorSpace);
-    NSAssert(bitmap, @"Can't create bitmap");
+    CGDataProviderRelease(provider);
+    NSAssert(thumbnail, @"Can't create image");
 
-    // Create the thumbnail image
-    //NSAssert(!_thumbnail, @"We already have a thumbnail");
     if (_thumbnail)
         CGImageRelease(_thumbnail);
-    _thumbnail = CGBitmapContextCreateImage(bitmap);
+    _thumbnail = thumbnail;
+    _thumbnailData = data;
     _thumbnailWidth = _effectiveThumbnailWidth;
     _thumbnailHeight = _effectiveThumbnailHeight;
+    [self storeThumbnailInDiskCache];
 
-    // Put a new context there.
-    CGContextRelease(bitmap);
-
-    // Make sure we don't block the video thread now
-    [self performSelector:@selector(notifyDelegate) withObject:nil afterDelay:0];
+    [self endThumbnailing];
+    [self notifyDelegateOfThumbnail];
 }
 
 - (void)stopAsync
@@ -323,34 +1096,38 @@ static void display(void *opaque, void *picture)
     if (_data)
         free(_data);
     _data = NULL;
-
-    _shouldRejectFrames = NO;
+    free(_bestFrame);
+    _bestFrame = NULL;
 }
 
 - (void)endThumbnailing
 {
     _shouldRejectFrames = YES;
 
-    [_thumbnailingTimeoutTimer invalidate];
-    _thumbnailingTimeoutTimer = nil;
+    [self cancelThumbnailingTimeoutTimer];
 
-    [self performSelectorInBackground:@selector(stopAsync) withObject:nil];
-}
-
-- (void)notifyDelegate
-{
-    [self endThumbnailing];
-
-    // Call delegate
-    [_thumbnailingDelegate mediaThumbnailer:self didFinishThumbnail:_thumbnail];
+    // The video thread may use the player and its buffer until the player
+    // is released. Hold our queue back meanwhile, the next fetch then finds
+    // both gone, without making anybody wait for the release.
+    dispatch_suspend(_queue);
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        [self stopAsync];
+        dispatch_resume(self->_queue);
+    });
 }
 
 - (void)mediaThumbnailingTimedOut
 {
+    // keep the tiles decoded so far
+    if (_spriteTileCount > 0 && _spriteSheet && _spriteTileIndex > 0) {
+        [self didFetchSpriteSheet];
+        return;
+    }
+
     VKLog(@"WARNING: media thumbnailer media thumbnailing timed out");
     [self endThumbnailing];
 
     // Call delegate
-    [_thumbnailingDelegate mediaThumbnailerDidTimeOut:self];
+    [self notifyDelegateOfTimeOut];
 }
 @end
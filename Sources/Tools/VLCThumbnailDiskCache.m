@@ -0,0 +1,438 @@
+/*****************************************************************************
+ * VLCThumbnailDiskCache.m: VLCKit.framework VLCThumbnailDiskCache implementation
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#import <VLCThumbnailDiskCache.h>
+#import <VLCMedia.h>
+#import <ImageIO/ImageIO.h>
+
+#include <os/lock.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+static const NSUInteger kDefaultByteLimit = 256 * 1024 * 1024;
+static const size_t kFingerprintChunkSize = 64 * 1024;
+static NSString *const kThumbnailExtension = @"png";
+
+/// 64-bit FNV-1a, plenty to tell apart a few sampled chunks
+static uint64_t FNV1a(uint64_t hash, const uint8_t *bytes, size_t length)
+{
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static const uint64_t kFNV1aOffsetBasis = 0xcbf29ce484222325ULL;
+
+/**
+ * Hashes the size of the file and three chunks: the start, the middle and the
+ * end. Reading 192 KiB at most keeps the cost independent of the media length.
+ */
+static BOOL FingerprintFile(const char *path, uint64_t *hash, uint64_t *size)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return NO;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return NO;
+    }
+
+    uint8_t *chunk = malloc(kFingerprintChunkSize);
+    if (!chunk) {
+        close(fd);
+        return NO;
+    }
+
+    const uint64_t fileSize = (uint64_t)st.st_size;
+    uint64_t h = FNV1a(kFNV1aOffsetBasis, (const uint8_t *)&fileSize, sizeof(fileSize));
+    const off_t offsets[] = {
+        0,
+        (off_t)(fileSize / 2),
+        (off_t)(fileSize > kFingerprintChunkSize ? fileSize - kFingerprintChunkSize : 0),
+    };
+    for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++) {
+        const ssize_t length = pread(fd, chunk, kFingerprintChunkSize, offsets[i]);
+        if (length < 0) {
+            free(chunk);
+            close(fd);
+            return NO;
+        }
+        h = FNV1a(h, chunk, (size_t)length);
+    }
+    free(chunk);
+    close(fd);
+
+    *hash = h;
+    *size = fileSize;
+    return YES;
+}
+
+/**
+ * One thumbnail on disk, linked in recency order. The dictionary of the cache
+ * owns the entries, the list links are therefore not retaining.
+ */
+@interface VLCThumbnailDiskCacheEntry : NSObject
+{
+@public
+    NSString *_key;
+    NSUInteger _bytes;
+    __unsafe_unretained VLCThumbnailDiskCacheEntry *_previous;
+    __unsafe_unretained VLCThumbnailDiskCacheEntry *_next;
+}
+@end
+
+@implementation VLCThumbnailDiskCacheEntry
+@end
+
+@implementation VLCThumbnailDiskCache
+{
+    os_unfair_lock _lock;               ///< Protects everything below
+    NSMutableDictionary<NSString *, VLCThumbnailDiskCacheEntry *> *_entries;
+    __unsafe_unretained VLCThumbnailDiskCacheEntry *_head;  ///< Most recently used
+    __unsafe_unretained VLCThumbnailDiskCacheEntry *_tail;  ///< Least recently used
+    NSUInteger _totalBytes;
+    NSUInteger _byteLimit;
+    NSUInteger _hitCount;
+    NSUInteger _missCount;
+    dispatch_queue_t _ioQueue;          ///< Serializes writes, deletions and the initial scan
+}
+
++ (VLCThumbnailDiskCache *)sharedCache
+{
+    static VLCThumbnailDiskCache *sharedCache;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSURL *cachesURL = [[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory inDomains:NSUserDomainMask].firstObject;
+        if (!cachesURL)
+            cachesURL = [NSURL fileURLWithPath:NSTemporaryDirectory() isDirectory:YES];
+        NSURL *directoryURL = [cachesURL URLByAppendingPathComponent:@"org.videolan.VLCKit.thumbnails" isDirectory:YES];
+        sharedCache = [[VLCThumbnailDiskCache alloc] initWithDirectoryURL:directoryURL byteLimit:kDefaultByteLimit];
+    });
+    return sharedCache;
+}
+
+- (instancetype)initWithDirectoryURL:(NSURL *)directoryURL byteLimit:(NSUInteger)byteLimit
+{
+    if (self = [super init]) {
+        _directoryURL = directoryURL;
+        _byteLimit = byteLimit;
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _entries = [NSMutableDictionary dictionary];
+        dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL,
+                                                                             QOS_CLASS_UTILITY,
+                                                                             0);
+        _ioQueue = dispatch_queue_create("org.videolan.VLCThumbnailDiskCache", attr);
+        dispatch_async(_ioQueue, ^{
+            [self loadDirectory];
+        });
+    }
+    return self;
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@ %p>, count: %lu, bytes: %lu/%lu, hits: %lu, misses: %lu", [self class], self, (unsigned long)self.count, (unsigned long)self.totalBytes, (unsigned long)self.byteLimit, (unsigned long)self.hitCount, (unsigned long)self.missCount];
+}
+
+#pragma mark - accounting
+
+- (NSUInteger)totalBytes
+{
+    os_unfair_lock_lock(&_lock);
+    const NSUInteger totalBytes = _totalBytes;
+    os_unfair_lock_unlock(&_lock);
+    return totalBytes;
+}
+
+- (NSUInteger)count
+{
+    os_unfair_lock_lock(&_lock);
+    const NSUInteger count = _entries.count;
+    os_unfair_lock_unlock(&_lock);
+    return count;
+}
+
+- (NSUInteger)hitCount
+{
+    os_unfair_lock_lock(&_lock);
+    const NSUInteger hitCount = _hitCount;
+    os_unfair_lock_unlock(&_lock);
+    return hitCount;
+}
+
+- (NSUInteger)missCount
+{
+    os_unfair_lock_lock(&_lock);
+    const NSUInteger missCount = _missCount;
+    os_unfair_lock_unlock(&_lock);
+    return missCount;
+}
+
+- (void)resetStatistics
+{
+    os_unfair_lock_lock(&_lock);
+    _hitCount = 0;
+    _missCount = 0;
+    os_unfair_lock_unlock(&_lock);
+}
+
+- (NSUInteger)byteLimit
+{
+    os_unfair_lock_lock(&_lock);
+    const NSUInteger byteLimit = _byteLimit;
+    os_unfair_lock_unlock(&_lock);
+    return byteLimit;
+}
+
+- (void)setByteLimit:(NSUInteger)byteLimit
+{
+    os_unfair_lock_lock(&_lock);
+    _byteLimit = byteLimit;
+    os_unfair_lock_unlock(&_lock);
+
+    dispatch_async(_ioQueue, ^{
+        [self trimToByteLimit];
+    });
+}
+
+- (void)removeAllImages
+{
+    dispatch_async(_ioQueue, ^{
+        os_unfair_lock_lock(&self->_lock);
+        NSArray<NSString *> *keys = self->_entries.allKeys;
+        [self->_entries removeAllObjects];
+        self->_head = self->_tail = nil;
+        self->_totalBytes = 0;
+        os_unfair_lock_unlock(&self->_lock);
+
+        NSFileManager *fileManager = [NSFileManager defaultManager];
+        for (NSString *key in keys)
+            [fileManager removeItemAtURL:[self fileURLForKey:key] error:nil];
+    });
+}
+
+#pragma mark - keys
+
+- (nullable NSString *)keyForMedia:(VLCMedia *)media size:(CGSize)size position:(float)position
+{
+    NSURL *url = media.url;
+    if (!url)
+        return nil;
+
+    uint64_t hash, fileSize = 0;
+    if (url.isFileURL) {
+        if (!FingerprintFile(url.fileSystemRepresentation, &hash, &fileSize))
+            return nil;
+    } else {
+        // remote content is not sampled, reading it would cost more than thumbnailing
+        const char *string = url.absoluteString.UTF8String;
+        hash = FNV1a(kFNV1aOffsetBasis, (const uint8_t *)string, strlen(string));
+    }
+
+    return [NSString stringWithFormat:@"%016llx-%llx-%lux%lu-%04u",
+            hash,
+            fileSize,
+            (unsigned long)size.width,
+            (unsigned long)size.height,
+            (unsigned)lroundf(position * 10000.f)];
+}
+
+- (NSURL *)fileURLForKey:(NSString *)key
+{
+    return [[_directoryURL URLByAppendingPathComponent:key isDirectory:NO] URLByAppendingPathExtension:kThumbnailExtension];
+}
+
+#pragma mark - reading and writing
+
+- (nullable CGImageRef)copyImageForKey:(NSString *)key
+{
+    NSURL *fileURL = [self fileURLForKey:key];
+    CGImageRef image = NULL;
+    CGImageSourceRef source = CGImageSourceCreateWithURL((__bridge CFURLRef)fileURL, NULL);
+    if (source) {
+        NSDictionary *options = @{ (__bridge NSString *)kCGImageSourceShouldCacheImmediately : @YES };
+        image = CGImageSourceCreateImageAtIndex(source, 0, (__bridge CFDictionaryRef)options);
+        CFRelease(source);
+    }
+
+    os_unfair_lock_lock(&_lock);
+    if (image) {
+        _hitCount++;
+        VLCThumbnailDiskCacheEntry *entry = _entries[key];
+        if (entry)
+            [self lockedMoveToHead:entry];
+    } else {
+        _missCount++;
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    if (image) {
+        // the modification date orders the entries again on the next launch
+        dispatch_async(_ioQueue, ^{
+            [fileURL setResourceValue:[NSDate date] forKey:NSURLContentModificationDateKey error:nil];
+        });
+    }
+    return image;
+}
+
+- (void)storeImage:(CGImageRef)image forKey:(NSString *)key
+{
+    CGImageRetain(image);
+    dispatch_async(_ioQueue, ^{
+        NSMutableData *data = [NSMutableData data];
+        CGImageDestinationRef destination = CGImageDestinationCreateWithData((__bridge CFMutableDataRef)data, CFSTR("public.png"), 1, NULL);
+        if (destination) {
+            CGImageDestinationAddImage(destination, image, NULL);
+            if (!CGImageDestinationFinalize(destination))
+                data = nil;
+            CFRelease(destination);
+        } else {
+            data = nil;
+        }
+        CGImageRelease(image);
+
+        if (!data)
+            return;
+        if (![data writeToURL:[self fileURLForKey:key] atomically:YES]) {
+            // the directory may have been removed behind our back
+            [[NSFileManager defaultManager] createDirectoryAtURL:self->_directoryURL withIntermediateDirectories:YES attributes:nil error:nil];
+            if (![data writeToURL:[self fileURLForKey:key] atomically:YES])
+                return;
+        }
+
+        os_unfair_lock_lock(&self->_lock);
+        [self lockedInsertKey:key bytes:data.length];
+        os_unfair_lock_unlock(&self->_lock);
+
+        [self trimToByteLimit];
+    });
+}
+
+#pragma mark - disk, called on the io queue
+
+- (void)loadDirectory
+{
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    [fileManager createDirectoryAtURL:_directoryURL withIntermediateDirectories:YES attributes:nil error:nil];
+
+    NSArray<NSURLResourceKey> *keys = @[NSURLFileSizeKey, NSURLContentModificationDateKey];
+    NSArray<NSURL *> *files = [fileManager contentsOfDirectoryAtURL:_directoryURL
+                                         includingPropertiesForKeys:keys
+                                                            options:NSDirectoryEnumerationSkipsHiddenFiles
+                                                              error:nil];
+    NSMutableArray<NSDictionary *> *found = [NSMutableArray arrayWithCapacity:files.count];
+    for (NSURL *file in files) {
+        if (![file.pathExtension isEqualToString:kThumbnailExtension])
+            continue;
+        NSDictionary<NSURLResourceKey, id> *values = [file resourceValuesForKeys:keys error:nil];
+        NSNumber *bytes = values[NSURLFileSizeKey];
+        NSDate *date = values[NSURLContentModificationDateKey];
+        if (!bytes || !date)
+            continue;
+        [found addObject:@{ @"key" : file.URLByDeletingPathExtension.lastPathComponent, @"bytes" : bytes, @"date" : date }];
+    }
+    // oldest first, so that the most recently used file ends up at the head
+    [found sortUsingDescriptors:@[[NSSortDescriptor sortDescriptorWithKey:@"date" ascending:YES]]];
+
+    os_unfair_lock_lock(&_lock);
+    for (NSDictionary *file in found)
+        [self lockedInsertKey:file[@"key"] bytes:[file[@"bytes"] unsignedIntegerValue]];
+    os_unfair_lock_unlock(&_lock);
+
+    [self trimToByteLimit];
+}
+
+- (void)trimToByteLimit
+{
+    NSMutableArray<NSString *> *evictedKeys = [NSMutableArray array];
+    os_unfair_lock_lock(&_lock);
+    while (_totalBytes > _byteLimit && _tail) {
+        VLCThumbnailDiskCacheEntry *entry = _tail;
+        _totalBytes -= entry->_bytes;
+        [self lockedUnlink:entry];
+        [evictedKeys addObject:entry->_key];
+        [_entries removeObjectForKey:entry->_key];
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    for (NSString *key in evictedKeys)
+        [fileManager removeItemAtURL:[self fileURLForKey:key] error:nil];
+}
+
+#pragma mark - LRU list, called with the lock held
+
+- (void)lockedInsertKey:(NSString *)key bytes:(NSUInteger)bytes
+{
+    VLCThumbnailDiskCacheEntry *entry = _entries[key];
+    if (entry) {
+        _totalBytes -= entry->_bytes;
+        [self lockedUnlink:entry];
+    } else {
+        entry = [[VLCThumbnailDiskCacheEntry alloc] init];
+        entry->_key = key;
+        _entries[key] = entry;
+    }
+    entry->_bytes = bytes;
+    _totalBytes += bytes;
+    [self lockedLinkAtHead:entry];
+}
+
+- (void)lockedMoveToHead:(VLCThumbnailDiskCacheEntry *)entry
+{
+    if (_head == entry)
+        return;
+    [self lockedUnlink:entry];
+    [self lockedLinkAtHead:entry];
+}
+
+- (void)lockedLinkAtHead:(VLCThumbnailDiskCacheEntry *)entry
+{
+    entry->_previous = nil;
+    entry->_next = _head;
+    if (_head)
+        _head->_previous = entry;
+    _head = entry;
+    if (!_tail)
+        _tail = entry;
+}
+
+- (void)lockedUnlink:(VLCThumbnailDiskCacheEntry *)entry
+{
+    if (entry->_previous)
+        entry->_previous->_next = entry->_next;
+    else
+        _head = entry->_next;
+    if (entry->_next)
+        entry->_next->_previous = entry->_previous;
+    else
+        _tail = entry->_previous;
+    entry->_previous = entry->_next = nil;
+}
+
+@end
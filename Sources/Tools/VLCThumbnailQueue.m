@@ -0,0 +1,525 @@
+/*****************************************************************************
+ * VLCThumbnailQueue.m: VLCKit.framework VLCThumbnailQueue implementation
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#import <VLCThumbnailQueue.h>
+#import <VLCMedia.h>
+#import <VLCTime.h>
+#import <VLCLibrary.h>
+#import <VLCLibVLCBridging.h>
+
+#include <vlc/vlc.h>
+#include <os/lock.h>
+
+static const CGFloat kDefaultThumbnailWidth = 320.;
+static const CGFloat kDefaultThumbnailHeight = 240.;
+static const float kDefaultSnapshotPosition = 0.3;
+static const int kMinimumReceivedFrames = 4;
+static const NSTimeInterval kLocalMediaTimeout = 10.;
+static const NSTimeInterval kRemoteMediaTimeout = 45.;
+
+/// the same decoding shortcuts as VLCMediaThumbnailer
+static const char *const kThumbnailingOptions[] = {
+    "no-audio",
+    "no-spu",
+    "avcodec-threads=1",
+    "avcodec-skip-idct=4",
+    "avcodec-skiploopfilter=3",
+    "deinterlace=-1",
+    "avi-index=3",
+    "codec=avcodec,none",
+};
+
+@class VLCThumbnailQueueWorker;
+
+@interface VLCThumbnailQueue ()
+- (void)worker:(VLCThumbnailQueueWorker *)worker didCaptureThumbnail:(CGImageRef)thumbnail;
+- (void)workerDidStop:(VLCThumbnailQueueWorker *)worker;
+@end
+
+/**
+ * One queued media, the settings are captured when it is queued
+ */
+@interface VLCThumbnailQueueItem : NSObject
+{
+@public
+    VLCMedia *_media;
+    VLCThumbnailQueueCompletionHandler _completionHandler;
+    CGSize _size;
+    float _position;
+}
+@end
+
+@implementation VLCThumbnailQueueItem
+@end
+
+/**
+ * A player and its frame buffer, both kept for the lifetime of the queue.
+ *
+ * libvlc calls back on its own threads, which never message the queue
+ * directly: the work is handed over to the queue's serial work queue, so
+ * that the last reference to the queue is never dropped on a libvlc thread.
+ */
+@interface VLCThumbnailQueueWorker : NSObject
+{
+@public
+    libvlc_media_player_t *_player;
+    __weak VLCThumbnailQueue *_queue;
+    dispatch_queue_t _workQueue;
+
+    VLCThumbnailQueueItem *_item;   ///< Only accessed on the work queue
+
+    // set on the work queue while the player is stopped, then owned by the video thread
+    void *_pixels;
+    size_t _capacity;
+    unsigned _width;
+    unsigned _height;
+    CGSize _targetSize;
+    float _targetPosition;
+    int _receivedFrames;
+    BOOL _seeked;
+    BOOL _captured;
+}
+- (nullable instancetype)initWithQueue:(VLCThumbnailQueue *)queue workQueue:(dispatch_queue_t)workQueue;
+- (void)didDisplayFrame;
+@end
+
+static unsigned SetupFormat(void **opaque, char *chroma,
+                            unsigned *width, unsigned *height,
+                            unsigned *pitches, unsigned *lines)
+{
+    VLCThumbnailQueueWorker *worker = (__bridge VLCThumbnailQueueWorker *)(*opaque);
+    if (*width == 0 || *height == 0)
+        return 0;
+
+    // Constraining to the aspect ratio of the video, like VLCMediaThumbnailer does.
+    const double ratio = MAX(worker->_targetSize.width / *width, worker->_targetSize.height / *height);
+    const unsigned scaledWidth = MAX((unsigned)round(*width * ratio), 1u);
+    const unsigned scaledHeight = MAX((unsigned)round(*height * ratio), 1u);
+
+    const size_t size = (size_t)scaledWidth * scaledHeight * 4;
+    if (size > worker->_capacity) {
+        // the previous content does not matter, only grow the buffer
+        void *pixels = realloc(worker->_pixels, size);
+        if (!pixels)
+            return 0;
+        worker->_pixels = pixels;
+        worker->_capacity = size;
+    }
+
+    memcpy(chroma, "RGBA", 4);
+    *width = worker->_width = scaledWidth;
+    *height = worker->_height = scaledHeight;
+    *pitches = 4 * scaledWidth;
+    *lines = scaledHeight;
+    return 1;
+}
+
+static void *LockFrame(void *opaque, void **pixels)
+{
+    VLCThumbnailQueueWorker *worker = (__bridge VLCThumbnailQueueWorker *)opaque;
+    *pixels = worker->_pixels;
+    return NULL;
+}
+
+static void DisplayFrame(void *opaque, void *picture)
+{
+    VLCThumbnailQueueWorker *worker = (__bridge VLCThumbnailQueueWorker *)opaque;
+    [worker didDisplayFrame];
+}
+
+static void PlayerStopped(const libvlc_event_t *event, void *opaque)
+{
+    // the player lock is held, no libvlc player call can be made from here
+    VLCThumbnailQueueWorker *worker = (__bridge VLCThumbnailQueueWorker *)opaque;
+    dispatch_async(worker->_workQueue, ^{
+        [worker->_queue workerDidStop:worker];
+    });
+}
+
+@implementation VLCThumbnailQueueWorker
+
+- (nullable instancetype)initWithQueue:(VLCThumbnailQueue *)queue workQueue:(dispatch_queue_t)workQueue
+{
+    if (self = [super init]) {
+        _queue = queue;
+        _workQueue = workQueue;
+        _player = libvlc_media_player_new(queue.library.instance);
+        if (!_player)
+            return nil;
+        libvlc_video_set_callbacks(_player, LockFrame, NULL, DisplayFrame, (__bridge void *)self);
+        libvlc_video_set_format_callbacks(_player, SetupFormat, NULL);
+        libvlc_event_attach(libvlc_media_player_event_manager(_player),
+                            libvlc_MediaPlayerStopped,
+                            PlayerStopped,
+                            (__bridge void *)self);
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    if (_player) {
+        libvlc_event_detach(libvlc_media_player_event_manager(_player),
+                            libvlc_MediaPlayerStopped,
+                            PlayerStopped,
+                            (__bridge void *)self);
+        // waits for the video thread, the buffer is unused afterwards
+        libvlc_media_player_release(_player);
+    }
+    free(_pixels);
+}
+
+- (void)didDisplayFrame
+{
+    // We may receive pictures after the one we kept. Just ignore.
+    if (_captured)
+        return;
+
+    _receivedFrames++;
+
+    // Make sure we are getting the right frame
+    if (!_seeked) {
+        _seeked = YES;
+        if (libvlc_media_player_get_position(_player) < _targetPosition / 2.) {
+            libvlc_media_player_set_position(_player, _targetPosition, true);
+            _receivedFrames = 0;
+            return;
+        }
+    }
+    // it isn't always best what comes first
+    if (_receivedFrames < kMinimumReceivedFrames)
+        return;
+
+    _captured = YES;
+
+    // a single copy out of the buffer, which the next frame would overwrite
+    const size_t pitch = 4 * (size_t)_width;
+    CFDataRef data = CFDataCreate(kCFAllocatorDefault, _pixels, (CFIndex)(pitch * _height));
+    CGDataProviderRef provider = CGDataProviderCreateWithCFData(data);
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+    CGImageRef thumbnail = CGImageCreate(_width, _height, 8, 32, pitch, colorSpace,
+                                         (CGBitmapInfo)kCGImageAlphaNoneSkipLast,
+                                         provider, NULL, false, kCGRenderingIntentDefault);
+    CGColorSpaceRelease(colorSpace);
+    CGDataProviderRelease(provider);
+    if (data)
+        CFRelease(data);
+
+    dispatch_async(_workQueue, ^{
+        [self->_queue worker:self didCaptureThumbnail:thumbnail];
+        CGImageRelease(thumbnail);
+    });
+}
+
+@end
+
+@implementation VLCThumbnailQueue
+{
+    os_unfair_lock _lock;               ///< Protects the pending items, the worker count and the statistics
+    NSMutableArray<VLCThumbnailQueueItem *> *_pendingItems;
+    NSMutableArray<VLCThumbnailQueueWorker *> *_workers;        ///< Keeps every worker alive
+    NSMutableArray<VLCThumbnailQueueWorker *> *_idleWorkers;
+    NSUInteger _workerCount;            ///< Including workers being created
+    NSUInteger _activeCount;
+    NSUInteger _completedCount;
+    NSUInteger _failedCount;
+    int64_t _busySince_us;
+    int64_t _busyDuration_us;
+    dispatch_queue_t _workQueue;
+    CGSize _thumbnailSize;
+    float _snapshotPosition;
+}
+
+@synthesize thumbnailSize = _thumbnailSize;
+@synthesize snapshotPosition = _snapshotPosition;
+
+- (instancetype)init
+{
+    return [self initWithLibrary:nil
+     maximumConcurrentThumbnails:[NSProcessInfo processInfo].activeProcessorCount];
+}
+
+- (instancetype)initWithLibrary:(nullable VLCLibrary *)library
+    maximumConcurrentThumbnails:(NSUInteger)maximumConcurrentThumbnails
+{
+    if (self = [super init]) {
+        _library = library ?: [VLCLibrary sharedLibrary];
+        _maximumConcurrentThumbnails = MAX(maximumConcurrentThumbnails, 1);
+        _thumbnailSize = CGSizeMake(kDefaultThumbnailWidth, kDefaultThumbnailHeight);
+        _snapshotPosition = kDefaultSnapshotPosition;
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _pendingItems = [NSMutableArray array];
+        _workers = [NSMutableArray array];
+        _idleWorkers = [NSMutableArray array];
+        dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL,
+                                                                             QOS_CLASS_UTILITY,
+                                                                             0);
+        _workQueue = dispatch_queue_create("org.videolan.VLCThumbnailQueue", attr);
+    }
+    return self;
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@ %p>, pending: %lu, players: %lu, thumbnails/s: %f", [self class], self, (unsigned long)self.pendingCount, (unsigned long)_maximumConcurrentThumbnails, self.thumbnailsPerSecond];
+}
+
+#pragma mark - statistics
+
+- (NSUInteger)pendingCount
+{
+    os_unfair_lock_lock(&_lock);
+    const NSUInteger pendingCount = _pendingItems.count;
+    os_unfair_lock_unlock(&_lock);
+    return pendingCount;
+}
+
+- (NSUInteger)completedCount
+{
+    os_unfair_lock_lock(&_lock);
+    const NSUInteger completedCount = _completedCount;
+    os_unfair_lock_unlock(&_lock);
+    return completedCount;
+}
+
+- (NSUInteger)failedCount
+{
+    os_unfair_lock_lock(&_lock);
+    const NSUInteger failedCount = _failedCount;
+    os_unfair_lock_unlock(&_lock);
+    return failedCount;
+}
+
+- (double)thumbnailsPerSecond
+{
+    os_unfair_lock_lock(&_lock);
+    int64_t busyDuration_us = _busyDuration_us;
+    if (_activeCount > 0)
+        busyDuration_us += libvlc_clock() - _busySince_us;
+    const NSUInteger completedCount = _completedCount;
+    os_unfair_lock_unlock(&_lock);
+
+    return busyDuration_us > 0 ? completedCount * 1000000. / busyDuration_us : 0.;
+}
+
+- (void)resetStatistics
+{
+    os_unfair_lock_lock(&_lock);
+    _completedCount = 0;
+    _failedCount = 0;
+    _busyDuration_us = 0;
+    _busySince_us = libvlc_clock();
+    os_unfair_lock_unlock(&_lock);
+}
+
+#pragma mark - queueing
+
+- (void)thumbnailMedia:(VLCMedia *)media
+     completionHandler:(nullable VLCThumbnailQueueCompletionHandler)completionHandler
+{
+    [self thumbnailMediaArray:@[media] completionHandler:completionHandler];
+}
+
+- (void)thumbnailMediaArray:(NSArray<VLCMedia *> *)mediaArray
+          completionHandler:(nullable VLCThumbnailQueueCompletionHandler)completionHandler
+{
+    const CGSize size = self.thumbnailSize;
+    const float position = self.snapshotPosition;
+
+    os_unfair_lock_lock(&_lock);
+    for (VLCMedia *media in mediaArray) {
+        VLCThumbnailQueueItem *item = [[VLCThumbnailQueueItem alloc] init];
+        item->_media = media;
+        item->_completionHandler = completionHandler;
+        item->_size = size;
+        item->_position = position;
+        [_pendingItems addObject:item];
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    __weak typeof(self) weakSelf = self;
+    dispatch_async(_workQueue, ^{
+        [weakSelf startPendingItems];
+    });
+}
+
+- (void)cancelPendingThumbnails
+{
+    os_unfair_lock_lock(&_lock);
+    [_pendingItems removeAllObjects];
+    os_unfair_lock_unlock(&_lock);
+}
+
+#pragma mark - work queue
+
+- (void)startPendingItems
+{
+    for (;;) {
+        VLCThumbnailQueueWorker *worker = nil;
+        VLCThumbnailQueueItem *item = nil;
+
+        os_unfair_lock_lock(&_lock);
+        if (_pendingItems.count > 0) {
+            if (_idleWorkers.count > 0) {
+                worker = _idleWorkers.lastObject;
+                [_idleWorkers removeLastObject];
+            } else if (_workerCount < _maximumConcurrentThumbnails) {
+                _workerCount++;
+            } else {
+                os_unfair_lock_unlock(&_lock);
+                return;
+            }
+            item = _pendingItems.firstObject;
+            [_pendingItems removeObjectAtIndex:0];
+            if (_activeCount++ == 0)
+                _busySince_us = libvlc_clock();
+        }
+        os_unfair_lock_unlock(&_lock);
+
+        if (!item)
+            return;
+
+        if (!worker) {
+            // players are only created while the pool grows, then reused
+            worker = [[VLCThumbnailQueueWorker alloc] initWithQueue:self workQueue:_workQueue];
+            os_unfair_lock_lock(&_lock);
+            if (worker)
+                [_workers addObject:worker];
+            else
+                _workerCount--;
+            os_unfair_lock_unlock(&_lock);
+            if (!worker) {
+                [self finishItem:item thumbnail:NULL];
+                return;
+            }
+        }
+
+        if (![self startItem:item onWorker:worker]) {
+            [self finishItem:item thumbnail:NULL];
+            os_unfair_lock_lock(&_lock);
+            [_idleWorkers addObject:worker];
+            os_unfair_lock_unlock(&_lock);
+        }
+    }
+}
+
+- (BOOL)startItem:(VLCThumbnailQueueItem *)item onWorker:(VLCThumbnailQueueWorker *)worker
+{
+    // a copy keeps these options away from the caller's media
+    libvlc_media_t *p_md = libvlc_media_duplicate([item->_media libVLCMediaDescriptor]);
+    if (!p_md)
+        return NO;
+
+    for (size_t i = 0; i < sizeof(kThumbnailingOptions) / sizeof(kThumbnailingOptions[0]); i++)
+        libvlc_media_add_option(p_md, kThumbnailingOptions[i]);
+
+    worker->_targetSize = item->_size;
+    worker->_targetPosition = item->_position;
+    worker->_receivedFrames = 0;
+    worker->_seeked = NO;
+    worker->_captured = NO;
+
+    // start right at the position when the length is known, else seek on the first frame
+    const int length = item->_media.length.intValue;
+    if (length > 1000) {
+        char option[32];
+        snprintf(option, sizeof(option), "start-time=%.3f", length * item->_position / 1000.);
+        libvlc_media_add_option(p_md, option);
+        worker->_seeked = YES;
+    }
+
+    worker->_item = item;
+    libvlc_media_player_set_media(worker->_player, p_md);
+    libvlc_media_release(p_md);
+    if (libvlc_media_player_play(worker->_player) != 0) {
+        worker->_item = nil;
+        return NO;
+    }
+
+    NSURL *url = item->_media.url;
+    const NSTimeInterval timeout = [url.scheme isEqualToString:@"file"] ? kLocalMediaTimeout : kRemoteMediaTimeout;
+    __weak typeof(self) weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC)), _workQueue, ^{
+        if (worker->_item != item)
+            return;
+        VKLog(@"WARNING: thumbnail queue timed out on %@", item->_media);
+        [weakSelf detachItemFromWorker:worker thumbnail:NULL];
+    });
+    return YES;
+}
+
+- (void)worker:(VLCThumbnailQueueWorker *)worker didCaptureThumbnail:(CGImageRef)thumbnail
+{
+    if (!worker->_item)
+        return;
+    [self detachItemFromWorker:worker thumbnail:thumbnail];
+}
+
+/// reports the current item and stops the player, the worker is reused once it stopped
+- (void)detachItemFromWorker:(VLCThumbnailQueueWorker *)worker thumbnail:(nullable CGImageRef)thumbnail
+{
+    VLCThumbnailQueueItem *item = worker->_item;
+    worker->_item = nil;
+    [self finishItem:item thumbnail:thumbnail];
+    libvlc_media_player_stop_async(worker->_player);
+}
+
+- (void)workerDidStop:(VLCThumbnailQueueWorker *)worker
+{
+    // the media ended or failed to open before a frame was kept
+    VLCThumbnailQueueItem *item = worker->_item;
+    worker->_item = nil;
+    if (item)
+        [self finishItem:item thumbnail:NULL];
+
+    os_unfair_lock_lock(&_lock);
+    [_idleWorkers addObject:worker];
+    os_unfair_lock_unlock(&_lock);
+
+    [self startPendingItems];
+}
+
+- (void)finishItem:(VLCThumbnailQueueItem *)item thumbnail:(nullable CGImageRef)thumbnail
+{
+    os_unfair_lock_lock(&_lock);
+    if (thumbnail)
+        _completedCount++;
+    else
+        _failedCount++;
+    if (--_activeCount == 0)
+        _busyDuration_us += libvlc_clock() - _busySince_us;
+    os_unfair_lock_unlock(&_lock);
+
+    VLCThumbnailQueueCompletionHandler completionHandler = item->_completionHandler;
+    if (!completionHandler)
+        return;
+
+    VLCMedia *media = item->_media;
+    CGImageRetain(thumbnail);
+    dispatch_async(self.completionQueue ?: dispatch_get_main_queue(), ^{
+        completionHandler(media, thumbnail);
+        CGImageRelease(thumbnail);
+    });
+}
+
+@end
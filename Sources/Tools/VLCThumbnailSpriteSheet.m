@@ -0,0 +1,235 @@
+/*****************************************************************************
+ * VLCThumbnailSpriteSheet.m: VLCKit.framework VLCThumbnailSpriteSheet implementation
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#import <VLCThumbnailSpriteSheet.h>
+#import <VLCTime.h>
+#import <VLCLibVLCBridging.h>
+
+static void releaseSpriteSheetPixels(void *info, const void *data, size_t size)
+{
+    CFRelease(info);
+}
+
+/// WebVTT timestamps are hh:mm:ss.ttt
+static NSString *WebVTTTimestamp(int64_t time_ms)
+{
+    return [NSString stringWithFormat:@"%02lld:%02lld:%02lld.%03lld",
+            time_ms / 3600000, time_ms / 60000 % 60, time_ms / 1000 % 60, time_ms % 1000];
+}
+
+@implementation VLCThumbnailSpriteSheet
+{
+    NSMutableData *_pixels;     ///< Every image one after the other, then a scratch row of tiles
+    size_t _pitch;
+    size_t _imageSize;          ///< Bytes of a full image
+    unsigned _tileWidth;
+    unsigned _tileHeight;
+    int64_t _duration_ms;
+    NSArray *_images;           ///< Owns the CGImageRef
+}
+
+- (nullable instancetype)initWithTileCount:(NSUInteger)tileCount
+                                   columns:(NSUInteger)columns
+                                      rows:(NSUInteger)rows
+                                 tileWidth:(unsigned)tileWidth
+                                tileHeight:(unsigned)tileHeight
+                                  duration:(int64_t)duration_ms
+{
+    if (tileCount == 0 || tileWidth == 0 || tileHeight == 0 || duration_ms <= 0)
+        return nil;
+
+    if (self = [super init]) {
+        _tileCount = tileCount;
+        _columns = MIN(MAX(columns, 1), tileCount);
+        const NSUInteger neededRows = (tileCount + _columns - 1) / _columns;
+        _rows = rows > 0 ? MIN(rows, neededRows) : neededRows;
+        const NSUInteger tilesPerImage = _columns * _rows;
+        _imageCount = (tileCount + tilesPerImage - 1) / tilesPerImage;
+        _tileWidth = tileWidth;
+        _tileHeight = tileHeight;
+        _tileSize = CGSizeMake(tileWidth, tileHeight);
+        _duration_ms = duration_ms;
+        _duration = [VLCTime timeWithNumber:@(duration_ms)];
+
+        _pitch = (size_t)_columns * tileWidth * 4;
+        _imageSize = _pitch * tileHeight * _rows;
+        // zero filled, tiles that never receive a frame stay black
+        _pixels = [NSMutableData dataWithLength:_imageSize * _imageCount + _pitch * tileHeight];
+        if (!_pixels)
+            return nil;
+    }
+    return self;
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@ %p>, tiles: %lu, columns: %lu, rows: %lu, images: %lu, tile size: %ux%u", [self class], self, (unsigned long)_tileCount, (unsigned long)_columns, (unsigned long)_rows, (unsigned long)_imageCount, _tileWidth, _tileHeight];
+}
+
+#pragma mark - bridging
+
+- (size_t)pitch
+{
+    return _pitch;
+}
+
+- (void *)pixelsOfTileAtIndex:(NSUInteger)index
+{
+    uint8_t *pixels = _pixels.mutableBytes;
+    if (index >= _tileCount)
+        return pixels + _imageSize * _imageCount;
+
+    const NSUInteger tilesPerImage = _columns * _rows;
+    const NSUInteger tile = index % tilesPerImage;
+    return pixels + _imageSize * (index / tilesPerImage)
+                  + _pitch * _tileHeight * (tile / _columns)
+                  + (size_t)_tileWidth * 4 * (tile % _columns);
+}
+
+- (int64_t)timeOfTileAtIndex:(NSUInteger)index
+{
+    // the middle of the part of the media covered by the tile
+    return (int64_t)((2 * index + 1) * (double)_duration_ms / (2 * _tileCount));
+}
+
+- (void)createImages
+{
+    if (_images)
+        return;
+
+    NSMutableArray *images = [NSMutableArray arrayWithCapacity:_imageCount];
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+    const NSUInteger tilesPerImage = _columns * _rows;
+    for (NSUInteger i = 0; i < _imageCount; i++) {
+        // the last image only keeps the rows holding tiles
+        const NSUInteger tiles = MIN(tilesPerImage, _tileCount - i * tilesPerImage);
+        const size_t height = (size_t)_tileHeight * ((tiles + _columns - 1) / _columns);
+
+        // the images read the buffer the frames were decoded into, no copy is made
+        CGDataProviderRef provider = CGDataProviderCreateWithData((void *)CFBridgingRetain(_pixels),
+                                                                  (uint8_t *)_pixels.mutableBytes + _imageSize * i,
+                                                                  _pitch * height,
+                                                                  releaseSpriteSheetPixels);
+        if (!provider)
+            break;
+        CGImageRef image = CGImageCreate(_pitch / 4,
+                                         height,
+                                         8,
+                                         32,
+                                         _pitch,
+                                         colorSpace,
+                                         (CGBitmapInfo)kCGImageAlphaNoneSkipLast,
+                                         provider,
+                                         NULL,
+                                         false,
+                                         kCGRenderingIntentDefault);
+        CGDataProviderRelease(provider);
+        if (!image)
+            break;
+        [images addObject:(__bridge_transfer id)image];
+    }
+    CGColorSpaceRelease(colorSpace);
+    _images = [images copy];
+}
+
+#pragma mark - reading
+
+- (nullable CGImageRef)imageAtIndex:(NSUInteger)index
+{
+    if (index >= _images.count)
+        return NULL;
+    return (__bridge CGImageRef)_images[index];
+}
+
+- (NSUInteger)tileIndexForTime:(VLCTime *)time
+{
+    NSNumber *value = time.value;
+    if (!value)
+        return NSNotFound;
+    const int64_t time_ms = value.longLongValue;
+    if (time_ms < 0 || time_ms >= _duration_ms)
+        return NSNotFound;
+    return (NSUInteger)(time_ms * (double)_tileCount / _duration_ms);
+}
+
+- (CGRect)rectOfTileAtIndex:(NSUInteger)tileIndex imageIndex:(nullable NSUInteger *)imageIndex
+{
+    if (tileIndex >= _tileCount)
+        return CGRectNull;
+
+    const NSUInteger tilesPerImage = _columns * _rows;
+    const NSUInteger tile = tileIndex % tilesPerImage;
+    if (imageIndex)
+        *imageIndex = tileIndex / tilesPerImage;
+    return CGRectMake((CGFloat)_tileWidth * (tile % _columns),
+                      (CGFloat)_tileHeight * (tile / _columns),
+                      _tileWidth,
+                      _tileHeight);
+}
+
+- (int64_t)startOfTileAtIndex:(NSUInteger)index
+{
+    return (int64_t)(index * (double)_duration_ms / _tileCount);
+}
+
+- (nullable NSString *)WebVTTStringWithImageNames:(NSArray<NSString *> *)imageNames
+{
+    if (imageNames.count < _imageCount)
+        return nil;
+
+    NSMutableString *track = [NSMutableString stringWithString:@"WEBVTT\n"];
+    for (NSUInteger i = 0; i < _tileCount; i++) {
+        NSUInteger imageIndex;
+        const CGRect rect = [self rectOfTileAtIndex:i imageIndex:&imageIndex];
+        [track appendFormat:@"\n%@ --> %@\n%@#xywh=%.0f,%.0f,%.0f,%.0f\n",
+         WebVTTTimestamp([self startOfTileAtIndex:i]),
+         WebVTTTimestamp([self startOfTileAtIndex:i + 1]),
+         imageNames[imageIndex],
+         rect.origin.x, rect.origin.y, rect.size.width, rect.size.height];
+    }
+    return track;
+}
+
+- (nullable NSData *)JSONDataWithImageNames:(NSArray<NSString *> *)imageNames
+{
+    if (imageNames.count < _imageCount)
+        return nil;
+
+    NSMutableArray *tiles = [NSMutableArray arrayWithCapacity:_tileCount];
+    for (NSUInteger i = 0; i < _tileCount; i++) {
+        NSUInteger imageIndex;
+        const CGRect rect = [self rectOfTileAtIndex:i imageIndex:&imageIndex];
+        [tiles addObject:@{
+            @"start" : @([self startOfTileAtIndex:i] / 1000.),
+            @"end" : @([self startOfTileAtIndex:i + 1] / 1000.),
+            @"image" : imageNames[imageIndex],
+            @"x" : @(rect.origin.x),
+            @"y" : @(rect.origin.y),
+            @"width" : @(rect.size.width),
+            @"height" : @(rect.size.height),
+        }];
+    }
+    return [NSJSONSerialization dataWithJSONObject:tiles options:0 error:nil];
+}
+
+@end
@@ -0,0 +1,427 @@
+/*****************************************************************************
+ * VLCVideoFrame.m: VLCKit.framework VLCVideoFrame implementation
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#import <VLCVideoFrame.h>
+#import <VLCVideoFramePool.h>
+#import <os/lock.h>
+
+typedef struct {
+    unsigned width;
+    unsigned height;
+    NSUInteger planes;
+    size_t pitches[3];
+    size_t lines[3];    ///< visible lines, the buffer holds them rounded up to kLinesAlignment
+    size_t offsets[3];
+    size_t size;
+} VLCVideoFrameLayout;
+
+typedef struct {
+    uint8_t *buffer;
+    bool held;          ///< the buffer is owned by a frame until it is recycled
+} VLCVideoFrameSlot;
+
+static const size_t kPitchAlignment = 32;
+static const size_t kLinesAlignment = 16;
+static const size_t kBufferAlignment = 64;
+
+static const char *const kChromas[] = {
+    [VLCVideoFramePixelFormatRGBA] = "RGBA",
+    [VLCVideoFramePixelFormatBGRA] = "BGRA",
+    [VLCVideoFramePixelFormatI420] = "I420",
+    [VLCVideoFramePixelFormatNV12] = "NV12",
+    [VLCVideoFramePixelFormatGray] = "GREY",
+};
+
+static size_t alignedSize(size_t size, size_t alignment)
+{
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+static VLCVideoFrameLayout frameLayout(VLCVideoFramePixelFormat format, unsigned width, unsigned height)
+{
+    VLCVideoFrameLayout layout = { .width = width, .height = height, .planes = 1, .lines = { height } };
+    size_t widths[3] = { width };
+    size_t bytesPerPixel[3] = { 1, 1, 1 };
+
+    switch (format) {
+        case VLCVideoFramePixelFormatRGBA:
+        case VLCVideoFramePixelFormatBGRA:
+            bytesPerPixel[0] = 4;
+            break;
+        case VLCVideoFramePixelFormatI420:
+            layout.planes = 3;
+            for (unsigned i = 1; i < 3; i++) {
+                widths[i] = (width + 1) / 2;
+                layout.lines[i] = (height + 1) / 2;
+            }
+            break;
+        case VLCVideoFramePixelFormatNV12:
+            layout.planes = 2;
+            widths[1] = (width + 1) / 2;
+            bytesPerPixel[1] = 2;
+            layout.lines[1] = (height + 1) / 2;
+            break;
+        case VLCVideoFramePixelFormatGray:
+            break;
+    }
+
+    for (NSUInteger i = 0; i < layout.planes; i++) {
+        layout.pitches[i] = alignedSize(widths[i] * bytesPerPixel[i], kPitchAlignment);
+        layout.offsets[i] = layout.size;
+        layout.size += layout.pitches[i] * alignedSize(layout.lines[i], kLinesAlignment);
+    }
+    return layout;
+}
+
+@interface VLCVideoFrame ()
+- (instancetype)initWithPool:(VLCVideoFramePool *)pool
+                 pixelFormat:(VLCVideoFramePixelFormat)pixelFormat
+                      layout:(const VLCVideoFrameLayout *)layout
+                      buffer:(uint8_t *)buffer
+                 bufferIndex:(NSUInteger)bufferIndex
+                  generation:(NSUInteger)generation
+           droppedFrameCount:(NSUInteger)droppedFrameCount;
+@end
+
+@interface VLCVideoFramePool ()
+- (unsigned)setupWithChroma:(char *)chroma
+                      width:(unsigned *)width
+                     height:(unsigned *)height
+                    pitches:(unsigned *)pitches
+                      lines:(unsigned *)lines;
+- (void)cleanup;
+- (void *)lockPlanes:(void **)planes;
+- (void)displayPicture:(void *)picture;
+@end
+
+static unsigned setupFormat(void **opaque, char *chroma,
+                            unsigned *width, unsigned *height,
+                            unsigned *pitches, unsigned *lines)
+{
+    VLCVideoFramePool *pool = (__bridge VLCVideoFramePool *)(*opaque);
+    const unsigned count = [pool setupWithChroma:chroma width:width height:height pitches:pitches lines:lines];
+    /* the video output holds the pool until its cleanup, the player may drop it meanwhile */
+    if (count > 0)
+        CFBridgingRetain(pool);
+    return count;
+}
+
+/* only called after a successful setup */
+static void cleanupFormat(void *opaque)
+{
+    VLCVideoFramePool *pool = (VLCVideoFramePool *)CFBridgingRelease(opaque);
+    [pool cleanup];
+}
+
+static void *lockFrame(void *opaque, void **planes)
+{
+    VLCVideoFramePool *pool = (__bridge VLCVideoFramePool *)(opaque);
+    return [pool lockPlanes:planes];
+}
+
+static void unlockFrame(void *opaque, void *picture, void *const *planes)
+{
+    (void)opaque;
+    (void)picture;
+    (void)planes;
+}
+
+static void displayFrame(void *opaque, void *picture)
+{
+    VLCVideoFramePool *pool = (__bridge VLCVideoFramePool *)(opaque);
+    [pool displayPicture:picture];
+}
+
+@implementation VLCVideoFramePool
+{
+    os_unfair_lock _lock;                   ///< Protects the slots and the layout
+    VLCVideoFrameHandler _handler;
+    dispatch_queue_t _queue;
+    VLCVideoFramePixelFormat _pixelFormat;
+    CGSize _size;
+    NSUInteger _bufferCount;
+    VLCVideoFrameSlot *_slots;
+    uint8_t *_scratchBuffer;                ///< Decoded into when every buffer is held, never delivered
+    VLCVideoFrameLayout _layout;
+    NSUInteger _generation;                 ///< Bumped whenever the buffers are released
+    NSUInteger _nextSlot;
+    NSUInteger _droppedFrameCount;
+}
+
+- (instancetype)initWithHandler:(VLCVideoFrameHandler)handler
+                    pixelFormat:(VLCVideoFramePixelFormat)pixelFormat
+                           size:(CGSize)size
+                    bufferCount:(NSUInteger)bufferCount
+                          queue:(dispatch_queue_t)queue
+{
+    self = [super init];
+    if (self) {
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _handler = [handler copy];
+        if (queue) {
+            _queue = queue;
+        } else {
+            dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INITIATED, 0);
+            _queue = dispatch_queue_create("org.videolan.vlcvideoframepool", attr);
+        }
+        _pixelFormat = pixelFormat;
+        _size = size;
+        _bufferCount = MAX(bufferCount, 1);
+        _slots = calloc(_bufferCount, sizeof(*_slots));
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    /* frames retain the pool, none is left to hold a buffer */
+    [self releaseBuffers];
+    free(_slots);
+}
+
+- (void)attachToPlayer:(libvlc_media_player_t *)playerInstance
+{
+    libvlc_video_set_format_callbacks(playerInstance, setupFormat, cleanupFormat);
+    libvlc_video_set_callbacks(playerInstance, lockFrame, unlockFrame, displayFrame, (__bridge void *)(self));
+}
+
+/* called with the lock held, the buffers of held slots are left to their frame */
+- (void)releaseBuffers
+{
+    for (NSUInteger i = 0; i < _bufferCount; i++) {
+        if (!_slots[i].held)
+            free(_slots[i].buffer);
+        _slots[i].buffer = NULL;
+        _slots[i].held = false;
+    }
+    free(_scratchBuffer);
+    _scratchBuffer = NULL;
+    _generation++;
+}
+
+- (unsigned)setupWithChroma:(char *)chroma
+                      width:(unsigned *)width
+                     height:(unsigned *)height
+                    pitches:(unsigned *)pitches
+                      lines:(unsigned *)lines
+{
+    unsigned frameWidth = (unsigned)lrint(_size.width);
+    unsigned frameHeight = (unsigned)lrint(_size.height);
+
+    if (frameWidth == 0 && frameHeight == 0) {
+        frameWidth = *width;
+        frameHeight = *height;
+    } else if (frameWidth == 0 && *height > 0) {
+        frameWidth = (unsigned)((uint64_t)frameHeight * *width / *height);
+    } else if (frameHeight == 0 && *width > 0) {
+        frameHeight = (unsigned)((uint64_t)frameWidth * *height / *width);
+    }
+    if (frameWidth == 0 || frameHeight == 0)
+        return 0;
+
+    VLCVideoFrameLayout layout = frameLayout(_pixelFormat, frameWidth, frameHeight);
+
+    os_unfair_lock_lock(&_lock);
+    [self releaseBuffers];
+    _layout = layout;
+    _nextSlot = 0;
+    _droppedFrameCount = 0;
+    BOOL allocated = posix_memalign((void **)&_scratchBuffer, kBufferAlignment, layout.size) == 0;
+    for (NSUInteger i = 0; allocated && i < _bufferCount; i++)
+        allocated = posix_memalign((void **)&_slots[i].buffer, kBufferAlignment, layout.size) == 0;
+    if (!allocated)
+        [self releaseBuffers];
+    os_unfair_lock_unlock(&_lock);
+
+    if (!allocated)
+        return 0;
+
+    memcpy(chroma, kChromas[_pixelFormat], 4);
+    *width = frameWidth;
+    *height = frameHeight;
+    for (NSUInteger i = 0; i < layout.planes; i++) {
+        pitches[i] = (unsigned)layout.pitches[i];
+        lines[i] = (unsigned)alignedSize(layout.lines[i], kLinesAlignment);
+    }
+    return (unsigned)_bufferCount;
+}
+
+- (void)cleanup
+{
+    os_unfair_lock_lock(&_lock);
+    [self releaseBuffers];
+    os_unfair_lock_unlock(&_lock);
+}
+
+- (void *)lockPlanes:(void **)planes
+{
+    os_unfair_lock_lock(&_lock);
+    NSUInteger index = NSNotFound;
+    for (NSUInteger i = 0; i < _bufferCount; i++) {
+        NSUInteger slot = (_nextSlot + i) % _bufferCount;
+        if (!_slots[slot].held) {
+            index = slot;
+            break;
+        }
+    }
+
+    uint8_t *buffer = _scratchBuffer;
+    if (index != NSNotFound) {
+        buffer = _slots[index].buffer;
+        _nextSlot = (index + 1) % _bufferCount;
+    }
+    for (NSUInteger i = 0; i < _layout.planes; i++)
+        planes[i] = buffer + _layout.offsets[i];
+    os_unfair_lock_unlock(&_lock);
+
+    /* the picture identifies the slot for display, NULL is the scratch buffer */
+    return index == NSNotFound ? NULL : (void *)(uintptr_t)(index + 1);
+}
+
+- (void)displayPicture:(void *)picture
+{
+    os_unfair_lock_lock(&_lock);
+    if (!picture) {
+        _droppedFrameCount++;
+        os_unfair_lock_unlock(&_lock);
+        return;
+    }
+
+    NSUInteger index = (uintptr_t)picture - 1;
+    _slots[index].held = true;
+    uint8_t *buffer = _slots[index].buffer;
+    VLCVideoFrameLayout layout = _layout;
+    NSUInteger generation = _generation;
+    NSUInteger droppedFrameCount = _droppedFrameCount;
+    _droppedFrameCount = 0;
+    os_unfair_lock_unlock(&_lock);
+
+    VLCVideoFrame *frame = [[VLCVideoFrame alloc] initWithPool:self
+                                                   pixelFormat:_pixelFormat
+                                                        layout:&layout
+                                                        buffer:buffer
+                                                   bufferIndex:index
+                                                    generation:generation
+                                             droppedFrameCount:droppedFrameCount];
+    VLCVideoFrameHandler handler = _handler;
+    dispatch_async(_queue, ^{
+        handler(frame);
+    });
+}
+
+- (void)recycleBufferAtIndex:(NSUInteger)index generation:(NSUInteger)generation buffer:(void *)buffer
+{
+    os_unfair_lock_lock(&_lock);
+    if (generation == _generation && index < _bufferCount && _slots[index].buffer == buffer) {
+        _slots[index].held = false;
+        buffer = NULL;
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    /* the output was cleaned up meanwhile, the buffer belonged to the frame */
+    free(buffer);
+}
+
+@end
+
+@implementation VLCVideoFrame
+{
+    VLCVideoFramePool *_pool;
+    VLCVideoFrameLayout _layout;
+    os_unfair_lock _lock;           ///< Protects _buffer against a concurrent recycle
+    uint8_t *_buffer;
+    NSUInteger _generation;
+}
+
+- (instancetype)initWithPool:(VLCVideoFramePool *)pool
+                 pixelFormat:(VLCVideoFramePixelFormat)pixelFormat
+                      layout:(const VLCVideoFrameLayout *)layout
+                      buffer:(uint8_t *)buffer
+                 bufferIndex:(NSUInteger)bufferIndex
+                  generation:(NSUInteger)generation
+           droppedFrameCount:(NSUInteger)droppedFrameCount
+{
+    self = [super init];
+    if (self) {
+        _pool = pool;
+        _layout = *layout;
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _buffer = buffer;
+        _generation = generation;
+        _pixelFormat = pixelFormat;
+        _width = layout->width;
+        _height = layout->height;
+        _bufferIndex = bufferIndex;
+        _droppedFrameCount = droppedFrameCount;
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [self recycle];
+}
+
+- (NSUInteger)planeCount
+{
+    return _layout.planes;
+}
+
+- (const void *)bytesOfPlane:(NSUInteger)plane
+{
+    if (plane >= _layout.planes)
+        return NULL;
+
+    os_unfair_lock_lock(&_lock);
+    const uint8_t *bytes = _buffer ? _buffer + _layout.offsets[plane] : NULL;
+    os_unfair_lock_unlock(&_lock);
+    return bytes;
+}
+
+- (size_t)pitchOfPlane:(NSUInteger)plane
+{
+    return plane < _layout.planes ? _layout.pitches[plane] : 0;
+}
+
+- (size_t)linesOfPlane:(NSUInteger)plane
+{
+    return plane < _layout.planes ? _layout.lines[plane] : 0;
+}
+
+- (void)recycle
+{
+    os_unfair_lock_lock(&_lock);
+    uint8_t *buffer = _buffer;
+    _buffer = NULL;
+    os_unfair_lock_unlock(&_lock);
+
+    if (buffer)
+        [_pool recycleBufferAtIndex:_bufferIndex generation:_generation buffer:buffer];
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"%@: %ux%u, buffer %lu", [super description], _width, _height, (unsigned long)_bufferIndex];
+}
+
+@end
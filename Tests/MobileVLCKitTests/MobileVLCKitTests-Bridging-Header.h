@@ -1 +1,3 @@
 #import <MobileVLCKit/MobileVLCKit.h>
+#import <MobileVLCKit/VLCMediaListShuffleDeck.h>
+#import <MobileVLCKit/VLCMediaStatsSampler+Internal.h>
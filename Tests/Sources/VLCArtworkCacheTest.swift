@@ -0,0 +1,130 @@
+/*****************************************************************************
+ * VLCArtworkCacheTest.swift
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+import XCTest
+import ImageIO
+
+class VLCArtworkCacheTest: XCTestCase {
+    private let size = CGSize(width: 32, height: 32)
+    private var directory: URL!
+
+    override func setUpWithError() throws {
+        directory = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString)
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+    }
+
+    override func tearDownWithError() throws {
+        try FileManager.default.removeItem(at: directory)
+    }
+
+    private func makeImageFile(_ name: String) throws -> URL {
+        let url = directory.appendingPathComponent("\(name).png")
+        let context = try XCTAssertNotNilAndUnwrap(CGContext(data: nil, width: 64, height: 64,
+                                                             bitsPerComponent: 8, bytesPerRow: 0,
+                                                             space: CGColorSpaceCreateDeviceRGB(),
+                                                             bitmapInfo: CGImageAlphaInfo.premultipliedLast.rawValue))
+        let image = try XCTAssertNotNilAndUnwrap(context.makeImage())
+        let destination = try XCTAssertNotNilAndUnwrap(CGImageDestinationCreateWithURL(url as CFURL, "public.png" as CFString, 1, nil))
+        CGImageDestinationAddImage(destination, image, nil)
+        XCTAssertTrue(CGImageDestinationFinalize(destination))
+        return url
+    }
+
+    private func load(_ url: URL, into cache: VLCArtworkCache) -> VLCPlatformImage? {
+        let loaded = expectation(description: "image loaded")
+        var result: VLCPlatformImage?
+        cache.loadImage(for: url, size: size) { image in
+            result = image
+            loaded.fulfill()
+        }
+        wait(for: [loaded], timeout: STANDARD_TIME_OUT)
+        return result
+    }
+
+    func testCostAccounting() throws {
+        let cache = VLCArtworkCache()
+        cache.scale = 1
+
+        XCTAssertNotNil(load(try makeImageFile("first"), into: cache))
+        let cost = cache.totalCost
+        // decoded at the requested size, not at the 64x64 of the file
+        XCTAssertGreaterThanOrEqual(cost, 32 * 32 * 4)
+        XCTAssertLessThan(cost, 64 * 64 * 4)
+
+        XCTAssertNotNil(load(try makeImageFile("second"), into: cache))
+        XCTAssertEqual(cache.count, 2)
+        XCTAssertEqual(cache.totalCost, 2 * cost)
+
+        cache.removeAllImages()
+        XCTAssertEqual(cache.count, 0)
+        XCTAssertEqual(cache.totalCost, 0)
+    }
+
+    func testLeastRecentlyUsedEviction() throws {
+        let cache = VLCArtworkCache()
+        cache.scale = 1
+        let urls = try ["first", "second", "third"].map { try makeImageFile($0) }
+
+        XCTAssertNotNil(load(urls[0], into: cache))
+        let cost = cache.totalCost
+        cache.totalCostLimit = 2 * cost
+        XCTAssertNotNil(load(urls[1], into: cache))
+
+        // touching the first image makes the second one the oldest
+        XCTAssertNotNil(cache.cachedImage(for: urls[0], size: size))
+        XCTAssertNotNil(load(urls[2], into: cache))
+        XCTAssertEqual(cache.count, 2)
+        XCTAssertEqual(cache.totalCost, 2 * cost)
+        XCTAssertNil(cache.cachedImage(for: urls[1], size: size))
+        XCTAssertNotNil(cache.cachedImage(for: urls[0], size: size))
+        XCTAssertNotNil(cache.cachedImage(for: urls[2], size: size))
+
+        // lowering the limit evicts right away, the most recent image stays
+        cache.totalCostLimit = cost
+        XCTAssertEqual(cache.count, 1)
+        XCTAssertEqual(cache.totalCost, cost)
+        XCTAssertNotNil(cache.cachedImage(for: urls[2], size: size))
+    }
+
+    func testIdenticalRequestsShareOneDecode() throws {
+        let cache = VLCArtworkCache()
+        let url = try makeImageFile("shared")
+
+        let loaded = expectation(description: "all images loaded")
+        loaded.expectedFulfillmentCount = 3
+        var images: [VLCPlatformImage] = []
+        for _ in 0..<3 {
+            cache.loadImage(for: url, size: size) { image in
+                if let image = image {
+                    images.append(image)
+                }
+                loaded.fulfill()
+            }
+        }
+        wait(for: [loaded], timeout: STANDARD_TIME_OUT)
+
+        XCTAssertEqual(images.count, 3)
+        XCTAssertTrue(images.allSatisfy { $0 === images[0] })
+        XCTAssertEqual(cache.count, 1)
+    }
+}
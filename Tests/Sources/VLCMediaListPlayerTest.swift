@@ -0,0 +1,65 @@
+/*****************************************************************************
+ * VLCMediaListPlayerTest.swift
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+import XCTest
+
+class VLCMediaListPlayerTest: XCTestCase {
+
+    func testPreparationParsesNextItem() {
+        let next = Video.test2.media
+        let player = VLCMediaListPlayer()
+        player.mediaList = VLCMediaList(array: [Video.test1.media, next])
+        player.preparesNextItem = true
+        // the first time change is already within the interval
+        player.preparationInterval = 3600
+
+        let parsed = expectation(for: NSPredicate { _, _ in next.parsedStatus == .done }, evaluatedWith: nil)
+        player.play()
+
+        wait(for: [parsed], timeout: STANDARD_TIME_OUT)
+        player.stop()
+    }
+
+    func testTransitionStatistics() {
+        let player = VLCMediaListPlayer()
+        player.mediaList = VLCMediaList(array: [Video.test1.media, Video.test2.media])
+        player.preparesNextItem = true
+
+        let playing = expectation(for: NSPredicate { _, _ in player.mediaPlayer.isPlaying }, evaluatedWith: nil)
+        player.play()
+        wait(for: [playing], timeout: STANDARD_TIME_OUT)
+        XCTAssertEqual(player.transitionCount, 0)
+
+        let transitioned = expectation(for: NSPredicate { _, _ in player.transitionCount == 1 }, evaluatedWith: nil)
+        player.mediaPlayer.position = 0.99
+        wait(for: [transitioned], timeout: STANDARD_TIME_OUT)
+        player.stop()
+
+        XCTAssertGreaterThan(player.lastTransitionGap, 0)
+        XCTAssertEqual(player.averageTransitionGap, player.lastTransitionGap)
+
+        player.resetTransitionStatistics()
+        XCTAssertEqual(player.transitionCount, 0)
+        XCTAssertEqual(player.averageTransitionGap, 0)
+    }
+}
@@ -0,0 +1,119 @@
+/*****************************************************************************
+ * VLCMediaListShuffleDeckTest.swift
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+import XCTest
+
+class VLCMediaListShuffleDeckTest: XCTestCase {
+    private func drawRound(_ deck: VLCMediaListShuffleDeck) -> [Int] {
+        var picks: [Int] = []
+        var index = deck.nextIndexRepeating(false)
+        while index != NSNotFound {
+            picks.append(index)
+            index = deck.nextIndexRepeating(false)
+        }
+        return picks
+    }
+
+    func testEachIndexOncePerRound() {
+        let deck = VLCMediaListShuffleDeck(count: 50, historyLimit: 100)
+
+        let round = drawRound(deck)
+        XCTAssertEqual(round.sorted(), Array(0..<50))
+        XCTAssertEqual(deck.nextIndexRepeating(false), NSNotFound)
+
+        // the next round does not start with the item that ended the previous one
+        var nextRound = [deck.nextIndexRepeating(true)]
+        XCTAssertNotEqual(nextRound[0], round.last)
+        nextRound += drawRound(deck)
+        XCTAssertEqual(nextRound.sorted(), Array(0..<50))
+    }
+
+    func testPickedByUser() {
+        let deck = VLCMediaListShuffleDeck(count: 10, historyLimit: 100)
+        deck.markIndex(asCurrent: 3)
+
+        let round = drawRound(deck)
+        XCTAssertEqual(round.count, 9)
+        XCTAssertFalse(round.contains(3))
+
+        for index in round.dropLast().reversed() {
+            XCTAssertEqual(deck.previousIndex(), index)
+        }
+        XCTAssertEqual(deck.previousIndex(), 3)
+    }
+
+    func testPeek() {
+        let deck = VLCMediaListShuffleDeck(count: 10, historyLimit: 100)
+        let peeked = deck.peekNextIndexRepeating(false)
+
+        XCTAssertEqual(deck.peekNextIndexRepeating(false), peeked)
+        XCTAssertEqual(deck.nextIndexRepeating(false), peeked)
+        XCTAssertEqual(drawRound(deck).count, 9)
+    }
+
+    func testHistoryLimit() {
+        let deck = VLCMediaListShuffleDeck(count: 10, historyLimit: 3)
+        let picks = (0..<5).map { _ in deck.nextIndexRepeating(false) }
+
+        XCTAssertEqual(deck.previousIndex(), picks[3])
+        XCTAssertEqual(deck.previousIndex(), picks[2])
+        XCTAssertEqual(deck.previousIndex(), NSNotFound)
+
+        // walking forward again replays the history before drawing
+        XCTAssertEqual(deck.nextIndexRepeating(false), picks[3])
+        XCTAssertEqual(deck.nextIndexRepeating(false), picks[4])
+        XCTAssertEqual(drawRound(deck).count, 5)
+    }
+
+    func testListChangesDuringRound() {
+        var items = Array(0..<20)
+        var nextItem = items.count
+        let deck = VLCMediaListShuffleDeck(count: items.count, historyLimit: 100)
+
+        var played = (0..<8).map { _ in items[deck.nextIndexRepeating(false)] }
+
+        // one played and two unplayed items leave the list
+        let removedIndexes = IndexSet([items.firstIndex(of: played[2])!] + items.indices.filter { !played.contains(items[$0]) }.prefix(2))
+        let removed = removedIndexes.map { items[$0] }
+        items = items.enumerated().filter { !removedIndexes.contains($0.offset) }.map { $0.element }
+        deck.removeIndexes(removedIndexes)
+        XCTAssertEqual(deck.count, items.count)
+
+        // and three new ones join it, in front and in the middle
+        let insertedIndexes = IndexSet([0, 5, 6])
+        for index in insertedIndexes {
+            items.insert(nextItem, at: index)
+            nextItem += 1
+        }
+        deck.insertIndexes(insertedIndexes)
+        XCTAssertEqual(deck.count, items.count)
+
+        // the history follows the items, without the removed one
+        XCTAssertEqual(items[deck.previousIndex()], played[6])
+        XCTAssertEqual(items[deck.nextIndexRepeating(false)], played[7])
+
+        played += drawRound(deck).map { items[$0] }
+        XCTAssertEqual(Set(played).count, played.count)
+        XCTAssertEqual(Set(played).subtracting(removed), Set(items))
+    }
+}
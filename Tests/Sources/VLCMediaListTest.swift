@@ -0,0 +1,166 @@
+/*****************************************************************************
+ * VLCMediaListTest.swift
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+import XCTest
+
+class VLCMediaListTest: XCTestCase {
+    private func makeMedia(_ count: Int) -> [VLCMedia] {
+        return (0..<count).compactMap { VLCMedia(url: URL(fileURLWithPath: "/tmp/\($0).mp4")) }
+    }
+
+    func testBulkOperations() {
+        let media = makeMedia(5)
+        let list = VLCMediaList()
+
+        XCTAssertEqual(list.addMedia(from: media), NSRange(location: 0, length: 5))
+        XCTAssertEqual(list.count, 5)
+
+        XCTAssertTrue(list.moveMedia(at: IndexSet([0, 1]), to: 3))
+        XCTAssertEqual((0..<list.count).compactMap { list.media(at: $0) }, [media[2], media[3], media[4], media[0], media[1]])
+
+        XCTAssertTrue(list.removeMedia(at: IndexSet([0, 4])))
+        XCTAssertEqual((0..<list.count).compactMap { list.media(at: $0) }, [media[3], media[4], media[0]])
+
+        XCTAssertFalse(list.removeMedia(at: IndexSet([3])))
+    }
+
+    func testIndexOfMedia() {
+        let media = makeMedia(100)
+        let list = VLCMediaList(array: media)
+
+        XCTAssertEqual(list.index(of: media[42]), 42)
+        XCTAssertTrue(list.removeMedia(at: 0))
+        XCTAssertEqual(list.index(of: media[42]), 41)
+        XCTAssertEqual(list.index(of: media[0]), NSNotFound)
+    }
+
+    func testSortedView() {
+        let media = makeMedia(5)
+        let list = VLCMediaList(array: [media[1], media[4], media[3]])
+        let view = VLCMediaListView(mediaList: list,
+                                    sortDescriptors: [NSSortDescriptor(key: "url.lastPathComponent", ascending: false)],
+                                    predicate: NSPredicate(format: "NOT url.lastPathComponent BEGINSWITH '3'"))
+        XCTAssertEqual(view.media, [media[4], media[1]])
+
+        var changes: [(IndexSet, IndexSet)] = []
+        view.changeHandler = { _, removed, inserted in changes.append((removed, inserted)) }
+
+        list.addMedia(from: [media[2], media[0]])
+        XCTAssertEqual(view.media, [media[4], media[2], media[1], media[0]])
+        XCTAssertEqual(changes.last?.1, IndexSet([1, 3]))
+
+        XCTAssertTrue(list.removeMedia(at: IndexSet([0, 2])))
+        XCTAssertEqual(view.media, [media[4], media[2], media[0]])
+        XCTAssertEqual(changes.last?.0, IndexSet([2]))
+
+        let count = changes.count
+        XCTAssertTrue(list.moveMedia(at: IndexSet([0]), to: 2))
+        XCTAssertEqual(changes.count, count)
+    }
+
+    func testSerialization() throws {
+        let media = makeMedia(3)
+        media[1].metaData.title = "Second"
+        let list = VLCMediaList(array: media)
+
+        let url = FileManager.default.temporaryDirectory.appendingPathComponent("\(UUID().uuidString).vlcl")
+        defer { try? FileManager.default.removeItem(at: url) }
+        try list.write(to: url)
+
+        let restored = try VLCMediaList(contentsOf: url)
+        XCTAssertEqual(restored.count, 3)
+        XCTAssertEqual(restored.media.map { $0.url }, media.map { $0.url })
+        XCTAssertEqual(restored.media(at: 1)?.metaData.title, "Second")
+
+        try Data("garbage".utf8).write(to: url)
+        XCTAssertThrowsError(try VLCMediaList(contentsOf: url))
+    }
+
+    func testSerializationKeepsTemplateOptions() throws {
+        let options = ["network-caching": 1000, "no-audio": NSNull()] as [String: Any]
+        let template = VLCMediaOptionTemplate(options: options)
+        let templated = makeMedia(2)
+        templated.forEach { template.apply(to: $0) }
+        let configured = makeMedia(2)
+        configured.forEach { $0.addOptions(options) }
+
+        let directory = FileManager.default.temporaryDirectory
+        let urls = (0..<4).map { directory.appendingPathComponent("\(UUID().uuidString)-\($0).vlcl") }
+        defer { urls.forEach { try? FileManager.default.removeItem(at: $0) } }
+        try VLCMediaList(array: templated).write(to: urls[0])
+        try VLCMediaList(array: configured).write(to: urls[1])
+        try VLCMediaList(array: makeMedia(2)).write(to: urls[2])
+
+        // a template records its options like addOptions: does
+        let written = try Data(contentsOf: urls[0])
+        XCTAssertEqual(written, try Data(contentsOf: urls[1]))
+        XCTAssertNotEqual(written, try Data(contentsOf: urls[2]))
+
+        // and they survive a round trip
+        try VLCMediaList(contentsOf: urls[0]).write(to: urls[3])
+        XCTAssertEqual(try Data(contentsOf: urls[3]), written)
+    }
+
+    // MARK: Benchmarks
+
+    /// Each item of a parsed playlist reaches the list through a libvlc event
+    func testInsertionThroughEvents() throws {
+        let count = 50_000
+        let url = FileManager.default.temporaryDirectory.appendingPathComponent("\(UUID().uuidString).m3u")
+        defer { try? FileManager.default.removeItem(at: url) }
+        let entries = (0..<count).map { "/tmp/\($0).mp4" }
+        try ("#EXTM3U\n" + entries.joined(separator: "\n") + "\n").write(to: url, atomically: true, encoding: .utf8)
+
+        measure {
+            guard let playlist = VLCMedia(url: url), let list = playlist.subitems else {
+                XCTFail("no subitems list")
+                return
+            }
+            let filled = expectation(forNotification: VLCMediaList.itemAddedNotification, object: list) { _ in
+                list.count == count
+            }
+            playlist.parse(options: .parseLocal)
+            wait(for: [filled], timeout: 60)
+        }
+    }
+
+    func testBulkInsertion() {
+        let media = makeMedia(50_000)
+        measure {
+            let list = VLCMediaList()
+            list.addMedia(from: media)
+            XCTAssertEqual(list.count, media.count)
+        }
+    }
+
+    func testRestoringSavedList() throws {
+        let url = FileManager.default.temporaryDirectory.appendingPathComponent("\(UUID().uuidString).vlcl")
+        defer { try? FileManager.default.removeItem(at: url) }
+        try VLCMediaList(array: makeMedia(100_000)).write(to: url)
+
+        measure {
+            let list = try? VLCMediaList(contentsOf: url)
+            XCTAssertEqual(list?.count, 100_000)
+        }
+    }
+}
@@ -0,0 +1,87 @@
+/*****************************************************************************
+ * VLCMediaMetaDataTest.swift
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+import XCTest
+
+class VLCMediaMetaDataTest: XCTestCase {
+    func testSetAndReadBack() throws {
+        let media = try XCTAssertNotNilAndUnwrap(VLCMedia(url: URL(string: "file:///dev/null")!))
+        let metaData = media.metaData
+
+        metaData.title = "title"
+        metaData.trackNumber = 3
+        metaData.setExtraValue("value", forKey: "key")
+
+        XCTAssertEqual(metaData.title, "title")
+        XCTAssertEqual(metaData.trackNumber, 3)
+        XCTAssertEqual(metaData.extraValue(forKey: "key"), "value")
+
+        let snapshot = metaData.snapshot()
+        XCTAssertEqual(snapshot.title, "title")
+        XCTAssertEqual(snapshot.trackNumber, 3)
+        XCTAssertEqual(snapshot.extra["key"], "value")
+
+        metaData.clearCache()
+        XCTAssertEqual(metaData.title, "title")
+    }
+
+    // MARK: Benchmarks
+
+    /// Memory held by the metadata of many media once a few fields were read
+    func testMemoryPerMedia() {
+        let count = 10_000
+        let block = {
+            var media = [VLCMedia]()
+            media.reserveCapacity(count)
+            for _ in 0..<count {
+                guard let item = VLCMedia(url: URL(string: "file:///dev/null")!) else { continue }
+                _ = item.metaData.title
+                _ = item.metaData.artist
+                media.append(item)
+            }
+        }
+
+        // memory metrics need a recent OS, older ones only get the time
+        if #available(macOS 10.15, iOS 13.0, tvOS 13.0, *) {
+            measure(metrics: [XCTMemoryMetric()], block: block)
+        } else {
+            measure(block)
+        }
+    }
+
+    /// Latency of cached reads, as done when building a library row
+    func testCachedReadLatency() throws {
+        let media = try XCTAssertNotNilAndUnwrap(VLCMedia(url: URL(string: "file:///dev/null")!))
+        let metaData = media.metaData
+        metaData.prefetch()
+
+        measure {
+            for _ in 0..<100_000 {
+                _ = metaData.title
+                _ = metaData.artist
+                _ = metaData.album
+                _ = metaData.trackNumber
+            }
+        }
+    }
+}
@@ -0,0 +1,64 @@
+/*****************************************************************************
+ * VLCMediaPlayerTest.swift
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+import XCTest
+
+class VLCMediaPlayerTest: XCTestCase {
+
+    func testVideoFrameHandler() throws {
+        let bufferCount = 3
+        let frameCount = 10
+        let queue = DispatchQueue(label: "org.videolan.VLCMediaPlayerTest")
+        let delivered = expectation(description: "video frame handler called")
+        delivered.expectedFulfillmentCount = frameCount
+        delivered.assertForOverFulfill = false
+        var bufferIndexes: [Int] = []
+
+        let player = VLCMediaPlayer()
+        player.setVideoFrameHandler({ frame in
+            XCTAssertEqual(frame.pixelFormat, .I420)
+            XCTAssertEqual(frame.width, 320)
+            XCTAssertEqual(frame.height, 240)
+            XCTAssertEqual(frame.planeCount, 3)
+            XCTAssertGreaterThanOrEqual(frame.pitch(ofPlane: 0), 320)
+            XCTAssertEqual(frame.lines(ofPlane: 1), 120)
+            XCTAssertNotNil(frame.bytes(ofPlane: 2))
+            XCTAssertNil(frame.bytes(ofPlane: 3))
+
+            bufferIndexes.append(Int(frame.bufferIndex))
+            frame.recycle()
+            XCTAssertNil(frame.bytes(ofPlane: 0))
+            delivered.fulfill()
+        }, pixelFormat: .I420, size: CGSize(width: 320, height: 240), bufferCount: bufferCount, queue: queue)
+        player.media = Video.test1.media
+        player.play()
+
+        wait(for: [delivered], timeout: STANDARD_TIME_OUT)
+        player.stop()
+
+        queue.sync {
+            // frames are recycled right away, every buffer is used in turn
+            XCTAssertEqual(Set(bufferIndexes), Set(0..<bufferCount))
+        }
+    }
+}
@@ -0,0 +1,112 @@
+/*****************************************************************************
+ * VLCMediaStatsSamplerTest.swift
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+import XCTest
+
+class VLCMediaStatsSamplerTest: XCTestCase {
+    private func makeSampler(capacity: Int = 60) throws -> VLCMediaStatsSampler {
+        let media = try XCTAssertNotNilAndUnwrap(VLCMedia(url: URL(string: "file:///dev/null")!))
+        return VLCMediaStatsSampler(media: media, interval: 1, capacity: capacity)
+    }
+
+    private func addSample(_ sampler: VLCMediaStatsSampler, seconds: Double, readBytes: Int64 = 0, displayedPictures: Int64 = 0) {
+        var counters = [Int64](repeating: 0, count: Int(VLCMediaStatsSampler.Metric.count.rawValue))
+        counters[Int(VLCMediaStatsSampler.Metric.inputBitrate.rawValue)] = readBytes
+        counters[Int(VLCMediaStatsSampler.Metric.displayedPictureRate.rawValue)] = displayedPictures
+        sampler.addSample(withCounters: counters, date: Int64(seconds * 1_000_000))
+    }
+
+    func testRateDerivation() throws {
+        let sampler = try makeSampler()
+
+        // the first counters are only the reference
+        addSample(sampler, seconds: 10, readBytes: 1000, displayedPictures: 100)
+        XCTAssertEqual(sampler.sampleCount, 0)
+        XCTAssertEqual(sampler.latestValue(for: .inputBitrate), 0)
+
+        addSample(sampler, seconds: 11, readBytes: 3000, displayedPictures: 125)
+        XCTAssertEqual(sampler.sampleCount, 1)
+        XCTAssertEqual(sampler.latestValue(for: .inputBitrate), 16000, accuracy: 0.001)
+        XCTAssertEqual(sampler.latestValue(for: .displayedPictureRate), 25, accuracy: 0.001)
+
+        addSample(sampler, seconds: 11.5, readBytes: 3500, displayedPictures: 140)
+        XCTAssertEqual(sampler.latestValue(for: .inputBitrate), 8000, accuracy: 0.001)
+        XCTAssertEqual(sampler.latestValue(for: .displayedPictureRate), 30, accuracy: 0.001)
+        XCTAssertEqual(sampler.latestValue(for: .droppedPictureRate), 0)
+
+        // counters restart when the media is played again
+        addSample(sampler, seconds: 12.5, readBytes: 200, displayedPictures: 5)
+        XCTAssertEqual(sampler.sampleCount, 3)
+        XCTAssertEqual(sampler.latestValue(for: .inputBitrate), 0)
+        XCTAssertEqual(sampler.latestValue(for: .displayedPictureRate), 0)
+
+        // a date that did not move forward gives no rate
+        addSample(sampler, seconds: 12.5, readBytes: 400)
+        XCTAssertEqual(sampler.sampleCount, 3)
+    }
+
+    func testRingBuffer() throws {
+        let sampler = try makeSampler(capacity: 3)
+        XCTAssertEqual(sampler.capacity, 3)
+
+        // one displayed picture more per sample: 1, 2, 3, 4, 5 per second
+        var displayed: Int64 = 0
+        for second in 0...5 {
+            displayed += Int64(second)
+            addSample(sampler, seconds: Double(second + 1), displayedPictures: displayed)
+        }
+        XCTAssertEqual(sampler.sampleCount, 3)
+        XCTAssertEqual(sampler.latestValue(for: .displayedPictureRate), 5, accuracy: 0.001)
+
+        // only the three newest samples are left
+        let window = sampler.window(for: .displayedPictureRate)
+        XCTAssertEqual(window.sampleCount, 3)
+        XCTAssertEqual(window.minimum, 3, accuracy: 0.001)
+        XCTAssertEqual(window.average, 4, accuracy: 0.001)
+        XCTAssertEqual(window.maximum, 5, accuracy: 0.001)
+
+        let recent = sampler.window(for: .displayedPictureRate, duration: 1)
+        XCTAssertEqual(recent.sampleCount, 2)
+        XCTAssertEqual(recent.minimum, 4, accuracy: 0.001)
+        XCTAssertEqual(recent.maximum, 5, accuracy: 0.001)
+
+        XCTAssertEqual(sampler.window(for: .displayedPictureRate, duration: 0).sampleCount, 0)
+    }
+
+    func testReset() throws {
+        let sampler = try makeSampler()
+        addSample(sampler, seconds: 1, readBytes: 100)
+        addSample(sampler, seconds: 2, readBytes: 200)
+        XCTAssertEqual(sampler.sampleCount, 1)
+
+        sampler.reset()
+        XCTAssertEqual(sampler.sampleCount, 0)
+        XCTAssertEqual(sampler.window(for: .inputBitrate).sampleCount, 0)
+
+        // no rate is derived across the reset
+        addSample(sampler, seconds: 10, readBytes: 100_000)
+        XCTAssertEqual(sampler.sampleCount, 0)
+        addSample(sampler, seconds: 11, readBytes: 100_100)
+        XCTAssertEqual(sampler.latestValue(for: .inputBitrate), 800, accuracy: 0.001)
+    }
+}
@@ -27,6 +27,8 @@ class MockThumbnailerDelegate: NSObject, VLCMediaThumbnailerDelegate {
     
     var timedOutExpectation: XCTestExpectation?
     var finishedExpectation: XCTestExpectation?
+    var spriteSheetExpectation: XCTestExpectation?
+    var finishedSemaphore: DispatchSemaphore?
     
     func mediaThumbnailerDidTimeOut(_ mediaThumbnailer: VLCMediaThumbnailer!) {
         timedOutExpectation?.fulfill()
@@ -34,6 +36,11 @@ class MockThumbnailerDelegate: NSObject, VLCMediaThumbnailerDelegate {
     
     func mediaThumbnailer(_ mediaThumbnailer: VLCMediaThumbnailer!, didFinishThumbnail thumbnail: CGImage!) {
         finishedExpectation?.fulfill()
+        finishedSemaphore?.signal()
+    }
+
+    func mediaThumbnailer(_ mediaThumbnailer: VLCMediaThumbnailer!, didFinish spriteSheet: VLCThumbnailSpriteSheet!) {
+        spriteSheetExpectation?.fulfill()
     }
     
 }
@@ -190,4 +197,224 @@ class VLCMediaThumbnailerTest: XCTestCase {
             XCTAssertEqual(thumbnailer.snapshotPosition, position)
         }
     }
+
+    func testThumbnailRequestMode() throws {
+        for video in Video.standards {
+            let delegate = MockThumbnailerDelegate()
+            let fetched = expectation(description: "delegate::didFinishThumbnail called")
+            delegate.finishedExpectation = fetched
+
+            let thumbnailer = try XCTAssertNotNilAndUnwrap(VLCMediaThumbnailer(media: video.media, andDelegate: delegate))
+            thumbnailer.mode = .thumbnailRequest
+            thumbnailer.fetchThumbnail()
+
+            wait(for: [fetched], timeout: STANDARD_TIME_OUT)
+
+            XCTAssertNotNil(thumbnailer.thumbnail)
+            XCTAssertEqual(thumbnailer.thumbnailHeight, 240)
+        }
+    }
+
+    func testSpriteSheet() throws {
+        let delegate = MockThumbnailerDelegate()
+        let fetched = expectation(description: "delegate::didFinishSpriteSheet called")
+        delegate.spriteSheetExpectation = fetched
+
+        let thumbnailer = try XCTAssertNotNilAndUnwrap(VLCMediaThumbnailer(media: Video.test1.media, andDelegate: delegate))
+        thumbnailer.thumbnailWidth = 160
+        thumbnailer.thumbnailHeight = 90
+        thumbnailer.fetchSpriteSheet(withTileCount: 10, columns: 4, rows: 2)
+
+        wait(for: [fetched], timeout: STANDARD_TIME_OUT * 4)
+
+        let sheet = try XCTAssertNotNilAndUnwrap(thumbnailer.spriteSheet)
+        XCTAssertEqual(sheet.tileCount, 10)
+        XCTAssertEqual(sheet.imageCount, 2)
+        XCTAssertEqual(sheet.image(at: 0)?.width, 4 * Int(sheet.tileSize.width))
+        XCTAssertEqual(sheet.image(at: 1)?.height, Int(sheet.tileSize.height))
+
+        var imageIndex: UInt = 0
+        let rect = sheet.rectOfTile(at: 9, imageIndex: &imageIndex)
+        XCTAssertEqual(imageIndex, 1)
+        XCTAssertEqual(rect.origin.x, sheet.tileSize.width)
+
+        let track = try XCTAssertNotNilAndUnwrap(sheet.webVTTString(withImageNames: ["0.png", "1.png"]))
+        XCTAssertTrue(track.hasPrefix("WEBVTT"))
+        XCTAssertEqual(track.components(separatedBy: "#xywh=").count, 11)
+        XCTAssertNil(sheet.webVTTString(withImageNames: ["0.png"]))
+
+        let json = try XCTAssertNotNilAndUnwrap(sheet.jsonData(withImageNames: ["0.png", "1.png"]))
+        let tiles = try XCTAssertNotNilAndUnwrap(try JSONSerialization.jsonObject(with: json) as? [[String: Any]])
+        XCTAssertEqual(tiles.count, 10)
+        XCTAssertEqual(tiles.last?["image"] as? String, "1.png")
+    }
+
+    func testDiskCache() throws {
+        let directory = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString)
+        defer { try? FileManager.default.removeItem(at: directory) }
+        let cache = VLCThumbnailDiskCache(directoryURL: directory, byteLimit: 10 * 1024 * 1024)
+
+        for expectedHits in [0, 1] {
+            let delegate = MockThumbnailerDelegate()
+            let fetched = expectation(description: "delegate::didFinishThumbnail called")
+            delegate.finishedExpectation = fetched
+
+            let thumbnailer = try XCTAssertNotNilAndUnwrap(VLCMediaThumbnailer(media: Video.test1.media, andDelegate: delegate))
+            thumbnailer.diskCache = cache
+            thumbnailer.fetchThumbnail()
+            wait(for: [fetched], timeout: STANDARD_TIME_OUT)
+
+            XCTAssertNotNil(thumbnailer.thumbnail)
+            XCTAssertEqual(cache.hitCount, expectedHits)
+            XCTAssertEqual(cache.missCount, 1)
+
+            // stored in the background
+            wait(for: [expectation(for: NSPredicate(format: "count == 1"), evaluatedWith: cache)], timeout: STANDARD_TIME_OUT)
+        }
+
+        cache.byteLimit = 0
+        wait(for: [expectation(for: NSPredicate(format: "totalBytes == 0"), evaluatedWith: cache)], timeout: STANDARD_TIME_OUT)
+    }
+
+    func testPixelFormats() throws {
+        let lumaSize = 417 * 240
+        let chromaSize = 209 * 120
+        let tests: [(format: VLCMediaThumbnailerPixelFormat, size: Int, bitsPerPixel: Int)] = [
+            (.RGBA, 4 * lumaSize, 32),
+            (.BGRA, 4 * lumaSize, 32),
+            (.I420, lumaSize + 2 * chromaSize, 8),
+            (.NV12, lumaSize + 2 * chromaSize, 8),
+            (.gray, lumaSize, 8)
+        ]
+
+        for (format, size, bitsPerPixel) in tests {
+            let delegate = MockThumbnailerDelegate()
+            let fetched = expectation(description: "delegate::didFinishThumbnail called")
+            delegate.finishedExpectation = fetched
+
+            let thumbnailer = try XCTAssertNotNilAndUnwrap(VLCMediaThumbnailer(media: Video.test1.media, andDelegate: delegate))
+            thumbnailer.pixelFormat = format
+            thumbnailer.fetchThumbnail()
+            wait(for: [fetched], timeout: STANDARD_TIME_OUT)
+
+            let data = try XCTAssertNotNilAndUnwrap(thumbnailer.thumbnailData)
+            let thumbnail = try XCTAssertNotNilAndUnwrap(thumbnailer.thumbnail)
+            XCTAssertEqual(data.count, size)
+            XCTAssertEqual(thumbnail.width, 417)
+            XCTAssertEqual(thumbnail.height, 240)
+            XCTAssertEqual(thumbnail.bitsPerPixel, bitsPerPixel)
+        }
+    }
+
+    func testFrameSelectionByScore() throws {
+        for video in Video.standards {
+            let delegate = MockThumbnailerDelegate()
+            let fetched = expectation(description: "delegate::didFinishThumbnail called")
+            delegate.finishedExpectation = fetched
+
+            let thumbnailer = try XCTAssertNotNilAndUnwrap(VLCMediaThumbnailer(media: video.media, andDelegate: delegate))
+            thumbnailer.frameSelection = .score
+            thumbnailer.pixelFormat = .gray
+            thumbnailer.fetchThumbnail()
+            wait(for: [fetched], timeout: STANDARD_TIME_OUT * 2)
+
+            // no black frame
+            let data = try XCTAssertNotNilAndUnwrap(thumbnailer.thumbnailData)
+            let mean = data.reduce(0) { $0 + Int($1) } / data.count
+            XCTAssertGreaterThan(mean, 24)
+        }
+    }
+
+    func testConcurrentThumbnailersOffTheMainThread() throws {
+        let delegateQueue = DispatchQueue(label: "org.videolan.VLCMediaThumbnailerTest")
+        let finished = DispatchSemaphore(value: 0)
+        var delegates: [MockThumbnailerDelegate] = []
+        var thumbnailers: [VLCMediaThumbnailer] = []
+
+        for video in Video.standards {
+            let delegate = MockThumbnailerDelegate()
+            delegate.finishedSemaphore = finished
+            delegates.append(delegate)
+
+            let thumbnailer = try XCTAssertNotNilAndUnwrap(VLCMediaThumbnailer(media: video.media, andDelegate: delegate))
+            thumbnailer.delegateQueue = delegateQueue
+            thumbnailers.append(thumbnailer)
+        }
+
+        DispatchQueue.concurrentPerform(iterations: thumbnailers.count) { thumbnailers[$0].fetchThumbnail() }
+
+        // the main thread is blocked meanwhile, nothing may depend on it
+        let deadline = DispatchTime.now() + STANDARD_TIME_OUT * 2
+        for _ in thumbnailers {
+            XCTAssertEqual(finished.wait(timeout: deadline), .success)
+        }
+        for thumbnailer in thumbnailers {
+            XCTAssertNotNil(thumbnailer.thumbnail)
+        }
+    }
+
+    // MARK: Benchmarks
+
+    private func measureThumbnailing(mode: VLCMediaThumbnailerMode) {
+        measure {
+            // the thumbnailers only hold their delegate weakly
+            var delegates: [MockThumbnailerDelegate] = []
+            var thumbnailers: [VLCMediaThumbnailer] = []
+            var expectations: [XCTestExpectation] = []
+            for video in Video.standards {
+                let delegate = MockThumbnailerDelegate()
+                let fetched = expectation(description: "delegate::didFinishThumbnail called")
+                delegate.finishedExpectation = fetched
+                expectations.append(fetched)
+                delegates.append(delegate)
+
+                let thumbnailer = VLCMediaThumbnailer(media: video.media, andDelegate: delegate)
+                thumbnailer.mode = mode
+                thumbnailer.fetchThumbnail()
+                thumbnailers.append(thumbnailer)
+            }
+            wait(for: expectations, timeout: STANDARD_TIME_OUT * Double(expectations.count))
+        }
+    }
+
+    func testPlaybackModePerformance() {
+        measureThumbnailing(mode: .playback)
+    }
+
+    func testThumbnailRequestModePerformance() {
+        measureThumbnailing(mode: .thumbnailRequest)
+    }
+
+    // MARK: Thumbnail queue
+
+    func testThumbnailQueue() throws {
+        let tests: [(video: Video, width: Int, height: Int)] = [
+            (Video.test1, 417, 240),
+            (Video.test2, 427, 240),
+            (Video.test3, 427, 240),
+            (Video.test4, 427, 240)
+        ]
+
+        let queue = VLCThumbnailQueue(library: nil, maximumConcurrentThumbnails: 2)
+        var sizes: [String: (Int, Int)] = [:]
+        let finished = expectation(description: "all thumbnails finished")
+        finished.expectedFulfillmentCount = tests.count
+
+        queue.thumbnailMediaArray(tests.map { $0.video.media }) { media, thumbnail in
+            if let thumbnail = thumbnail, let name = media.url?.lastPathComponent {
+                sizes[name] = (thumbnail.width, thumbnail.height)
+            }
+            finished.fulfill()
+        }
+        wait(for: [finished], timeout: STANDARD_TIME_OUT * Double(tests.count))
+
+        XCTAssertEqual(queue.completedCount, tests.count)
+        XCTAssertEqual(queue.failedCount, 0)
+        XCTAssertGreaterThan(queue.thumbnailsPerSecond, 0)
+        for (video, width, height) in tests {
+            let size = try XCTAssertNotNilAndUnwrap(sizes[video.url.lastPathComponent])
+            XCTAssertEqual(size.0, width)
+            XCTAssertEqual(size.1, height)
+        }
+    }
 }
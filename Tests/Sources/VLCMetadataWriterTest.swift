@@ -0,0 +1,139 @@
+/*****************************************************************************
+ * VLCMetadataWriterTest.swift
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ * $Id$
+ *
+ * Authors:
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+import XCTest
+
+class VLCMetadataWriterTest: XCTestCase {
+    private let eventQueue = DispatchQueue(label: "org.videolan.VLCMetadataWriterTest")
+    private var events: [String] = []
+
+    private func record(_ event: String) {
+        eventQueue.sync { events.append(event) }
+    }
+
+    private func recordedEvents() -> [String] {
+        return eventQueue.sync { events }
+    }
+
+    private func makeMedia(_ name: String) throws -> VLCMedia {
+        return try XCTAssertNotNilAndUnwrap(VLCMedia(url: URL(fileURLWithPath: "/tmp/\(name).mp3")))
+    }
+
+    /// queues a save of media whose edit blocks until the returned semaphore is signaled
+    private func startBlockingSave(of media: VLCMedia, writer: VLCMetadataWriter, completed: XCTestExpectation) -> DispatchSemaphore {
+        let started = DispatchSemaphore(value: 0)
+        let release = DispatchSemaphore(value: 0)
+        writer.update(media, with: { _ in
+            started.signal()
+            release.wait()
+            self.record("blocking")
+        }, completionHandler: { _, _ in
+            completed.fulfill()
+        })
+        started.wait()
+        return release
+    }
+
+    func testPendingEditsAreCoalesced() throws {
+        let writer = VLCMetadataWriter(maximumConcurrentSaves: 1)
+        let busy = try makeMedia("busy")
+        let media = try makeMedia("coalesced")
+
+        let completed = expectation(description: "saves completed")
+        completed.expectedFulfillmentCount = 4
+        let release = startBlockingSave(of: busy, writer: writer, completed: completed)
+
+        for i in 0..<3 {
+            writer.update(media, with: { _ in self.record("edit \(i)") }, completionHandler: { savedMedia, _ in
+                XCTAssertEqual(savedMedia, media)
+                self.record("completion \(i)")
+                completed.fulfill()
+            })
+        }
+        XCTAssertEqual(writer.pendingCount, 1)
+
+        release.signal()
+        wait(for: [completed], timeout: STANDARD_TIME_OUT)
+
+        // all edits go into a single save, in queueing order
+        XCTAssertEqual(recordedEvents(), ["blocking", "edit 0", "edit 1", "edit 2", "completion 0", "completion 1", "completion 2"])
+        XCTAssertEqual(writer.pendingCount, 0)
+    }
+
+    func testEditsDuringSaveAreSavedAfterwards() throws {
+        let writer = VLCMetadataWriter(maximumConcurrentSaves: 2)
+        let media = try makeMedia("followup")
+
+        let completed = expectation(description: "saves completed")
+        completed.expectedFulfillmentCount = 2
+        let release = startBlockingSave(of: media, writer: writer, completed: completed)
+
+        // a free worker does not pick up the media while it is being written
+        writer.update(media, with: { _ in self.record("follow-up") }, completionHandler: { _, _ in
+            completed.fulfill()
+        })
+        XCTAssertEqual(writer.pendingCount, 1)
+
+        release.signal()
+        wait(for: [completed], timeout: STANDARD_TIME_OUT)
+
+        XCTAssertEqual(recordedEvents(), ["blocking", "follow-up"])
+        XCTAssertEqual(writer.pendingCount, 0)
+    }
+
+    func testCompletionDelivery() throws {
+        let writer = VLCMetadataWriter(maximumConcurrentSaves: 1)
+        let busy = try makeMedia("busy")
+        let media = try (0..<3).map { try makeMedia("delivered \($0)") }
+
+        let completed = expectation(description: "saves completed")
+        completed.expectedFulfillmentCount = 2 + media.count
+        let release = startBlockingSave(of: busy, writer: writer, completed: completed)
+
+        // cancelled saves never call their completion handler
+        let cancelled = expectation(description: "cancelled save completed")
+        cancelled.isInverted = true
+        writer.save(try makeMedia("cancelled")) { _, _ in cancelled.fulfill() }
+        writer.cancelPendingSaves()
+        XCTAssertEqual(writer.pendingCount, 0)
+
+        var savedMedia: [VLCMedia] = []
+        for item in media {
+            writer.save(item) { saved, _ in
+                XCTAssertTrue(Thread.isMainThread)
+                savedMedia.append(saved)
+                completed.fulfill()
+            }
+        }
+        // every handler of a coalesced save is called
+        writer.save(media[0]) { saved, _ in
+            XCTAssertEqual(saved, media[0])
+            completed.fulfill()
+        }
+
+        release.signal()
+        wait(for: [completed], timeout: STANDARD_TIME_OUT)
+        wait(for: [cancelled], timeout: 0.5)
+        XCTAssertEqual(savedMedia, media)
+    }
+}
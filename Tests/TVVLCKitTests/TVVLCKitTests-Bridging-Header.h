@@ -1 +1,3 @@
 #import <TVVLCKit/TVVLCKit.h>
+#import <TVVLCKit/VLCMediaListShuffleDeck.h>
+#import <TVVLCKit/VLCMediaStatsSampler+Internal.h>
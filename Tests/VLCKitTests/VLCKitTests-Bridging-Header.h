@@ -1 +1,3 @@
 #import <VLCKit/VLCKit.h>
+#import <VLCKit/VLCMediaListShuffleDeck.h>
+#import <VLCKit/VLCMediaStatsSampler+Internal.h>